@@ -1,23 +1,64 @@
+#define _XOPEN_SOURCE 600 // importante para usleep e pthread_condattr_setclock
 #include "aeronave.h"
 #include "rota.h"
 #include "setor.h"
+#include "escala.h"
 #include "utils.h"
+#include "perfil.h"
+#include "memoria.h"
 #include <unistd.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-void* aeronave_thread(void* arg) {
-    aeronave_t* aero = (aeronave_t *)arg;
-    
+// Percorre a rota a partir de rota.curr (solicitar, entrar, liberar o anterior, voar).
+// Retorna o último setor da rota, que continua ocupado pela aeronave.
+static setor_t* percorrer_rota(aeronave_t* aero) {
     setor_t* setor_alvo = NULL;
-    setor_t* setor_prev = NULL;
+    // Restaurada de um checkpoint, a aeronave pode já ocupar um setor e estar na fila do próximo
+    int ocupado = aero->estado->current_setor;
+    setor_t* setor_prev = ocupado >= 0 ? &aero->controle->setores[ocupado] : NULL;
+    bool reservado = aero->estado->retomar_aguardando; // Solicitação do setor alvo já enviada (lookahead ou fila restaurada)
+    aero->estado->retomar_aguardando = false;
+    escala_t* escala = aero->controle->escala;
+    unsigned int prazo_ms = aero->controle->prazo_setor_ms;
+    int salto = 0;
     
     // O loop continua enquanto houver um próximo setor na rota
-    while ((setor_alvo = rota_next_setor(&aero->rota)) != NULL) {
-        // Solicita o próximo setor
-        // A aeronave espera DENTRO desta função se for negada.
-        printf_timestamped("[AERONAVE %s] SOLICITANDO ENTRADA no Setor %s. Prioridade: %u\n", aero->id, setor_alvo->id, aero->prioridade);
-        setor_solicitar_entrada(setor_alvo, aero); 
+    while (true) {
+        // Início do salto: sem solicitação em aberto, é onde a aeronave para para um checkpoint
+        if (!reservado) {
+            controle_ponto_seguro(aero->controle);
+        }
+        if ((setor_alvo = rota_next_setor(&aero->rota)) == NULL) break;
+
+        bool concedido = true;
+        if (reservado) {
+            // A solicitação foi feita durante o voo no setor anterior, resta aguardar a concessão
+            // (normalmente já concedida, então a troca é só liberar e entrar)
+            concedido = setor_aguardar_concessao_prazo(setor_alvo, aero, prazo_ms);
+        } else if (escala != NULL) {
+            // Entra na vez do seu bilhete da escala, sem consultar o banqueiro. Se a escala foi
+            // abandonada, segue pelo controle online e o salto fica com uma única amostra de espera
+            long long inicio_ns = tempo_monotonico_ns();
+            if (!escala_entrar(escala, setor_alvo, aero, salto, inicio_ns)) {
+                printf_timestamped("[AERONAVE %s] SOLICITANDO ENTRADA no Setor %s. Prioridade: %u\n", aero->id, setor_alvo->id, aero->prioridade);
+                setor_solicitar_entrada_desde(setor_alvo, aero, inicio_ns);
+            }
+        } else {
+            // Solicita o próximo setor
+            // A aeronave espera DENTRO desta função se for negada.
+            printf_timestamped("[AERONAVE %s] SOLICITANDO ENTRADA no Setor %s. Prioridade: %u\n", aero->id, setor_alvo->id, aero->prioridade);
+            concedido = setor_solicitar_entrada_prazo(setor_alvo, aero, prazo_ms);
+        }
+
+        if (!concedido) {
+            // Prazo expirado: o banqueiro já a retirou da fila e reposicionou `rota.curr`
+            // (desvio ou nova ordem dos setores restantes); segue para o novo próximo setor
+            printf_timestamped("[AERONAVE %s] PRAZO EXPIRADO no Setor %s. Reencaminhando.\n", aero->id, setor_alvo->id);
+            reservado = false;
+            continue;
+        }
         printf_timestamped("[AERONAVE %s] ENTRANDO no Setor %s. Prioridade: %u\n", aero->id, setor_alvo->id, aero->prioridade);
 
         if (setor_prev != NULL) {
@@ -28,52 +69,120 @@ void* aeronave_thread(void* arg) {
         
         // Atualiza o setor anterior para o próximo ciclo
         setor_prev = setor_alvo;
+        salto++;
 
         // Atualiza o setor atual da aeronave
-        pthread_mutex_lock(&aero->lock);
-        aero->current_setor = setor_alvo;
-        pthread_mutex_unlock(&aero->lock);
+        long long adquirido_ns = perfil_lock(&aero->estado->lock, PERFIL_LOCK_AERONAVE);
+        aero->estado->current_setor = setor_alvo->setor_index;
+        perfil_unlock(&aero->estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+
+        // Lookahead: solicita o próximo setor antes de voar, sobrepondo a decisão do banqueiro ao voo
+        setor_t* setor_prox = NULL;
+        reservado = false;
+        if (setor_alvo->controle->lookahead && (setor_prox = rota_peek_setor(&aero->rota)) != NULL) {
+            printf_timestamped("[AERONAVE %s] RESERVANDO o Setor %s. Prioridade: %u\n", aero->id, setor_prox->id, aero->prioridade);
+            setor_enviar_solicitacao(setor_prox, aero);
+            reservado = true;
+        }
 
         // Simulação de uso do recurso (Voo no setor)
         usar_setor(aero, setor_alvo);
     }
+
+    return setor_prev;
+}
+
+void* aeronave_thread(void* arg) {
+    aeronave_t* aero = (aeronave_t *)arg;
+
+    setor_t* setor_prev = percorrer_rota(aero);
     
-    // Ao finalizar, libera o último setor caso exista
-    if (setor_prev != NULL) {
+    // Ao finalizar, libera o último setor caso exista (na vez do bilhete de saída, se houver escala)
+    escala_t* escala = aero->controle->escala;
+    if (escala != NULL && escala_sair(escala, setor_prev, aero)) {
+        printf_timestamped("[AERONAVE %s] SAIU pela escala.\n", aero->id);
+    } else if (setor_prev != NULL) {
         printf_timestamped("[AERONAVE %s] SAINDO do Setor %s.\n", aero->id, setor_prev->id);
         setor_liberar_saida(setor_prev, aero);
     }
 
-    pthread_mutex_lock(&aero->lock);
-    aero->finished = true;
+    long long adquirido_ns = perfil_lock(&aero->estado->lock, PERFIL_LOCK_AERONAVE);
+    aero->estado->finished = true;
     printf_timestamped("[AERONAVE %s] ROTA CONCLUIDA E LIBERADA.\n", aero->id);
 
     resultado_aeronave_t* resultado = (resultado_aeronave_t*)malloc(sizeof(resultado_aeronave_t));
     if (resultado == NULL) return NULL;
-    long long espera_ns = aero->espera_total_ns;
-    pthread_mutex_unlock(&aero->lock);
+    long long espera_ns = aero->estado->espera_total_ns;
+    long long espera_max_ns = aero->estado->espera_max_ns;
+    unsigned int timeouts = aero->estado->timeouts;
+    perfil_unlock(&aero->estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
 
     resultado->id = aero->id;
     resultado->media_espera = (double)espera_ns / (double)(aero->rota.len * 1000000LL);
+    resultado->maior_espera = (double)espera_max_ns / 1000000.0;
+    resultado->timeouts = timeouts;
     
     
     return (void*)resultado;
 
 }
 
-void init_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len) {
+void* aeronave_thread_continuo(void* arg) {
+    aeronave_t* aero = (aeronave_t *)arg;
+
+    setor_t* setor_prev = percorrer_rota(aero);
+
+    long long adquirido_ns = perfil_lock(&aero->estado->lock, PERFIL_LOCK_AERONAVE);
+    aero->estado->finished = true;
+    perfil_unlock(&aero->estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+
+    printf_timestamped("[AERONAVE %s] ROTA CONCLUIDA. Solicitando aposentadoria.\n", aero->id);
+
+    // A aposentadoria libera o último setor, registra as estatísticas e devolve o slot.
+    // Depois do envio o slot pode ser reutilizado a qualquer momento: não tocar mais em `aero`.
+    mensagem_t* msg = &aero->estado->msg_controle;
+    caixa_postal_reservar(msg);
+    msg->tipo = MSG_APOSENTADORIA;
+    msg->aero_index = aero->aero_index;
+    msg->setor_index = setor_prev != NULL ? setor_prev->setor_index : -1;
+    caixa_postal_enviar(&aero->controle->caixa, msg);
+
+    return NULL;
+}
+
+void init_aeronaves(aeronave_t* aeronaves, aeronave_estado_t* estados, size_t aeronaves_len, controle_t* controle) {
     for (size_t i = 0; i < aeronaves_len; i++) {
         aeronaves[i].id = create_id('A',i);
-        aeronaves[i].prioridade = rand() % 1001;
+        aeronaves[i].prioridade = (unsigned int)aleatorio_intervalo(&controle->aleatorio, 1001);
         aeronaves[i].aero_index = i;
-        aeronaves[i].current_setor = NULL;
-        aeronaves[i].finished = false;
-        aeronaves[i].espera_total_ns = 0;
-        pthread_mutex_init(&aeronaves[i].lock, NULL);
+        aeronaves[i].chegada_ns = 0;
+        aeronaves[i].rota.head = aeronaves[i].rota.tail = aeronaves[i].rota.curr = NULL;
+        aeronaves[i].rota.len = 0;
+        aeronaves[i].estado = &estados[i];
+        aeronaves[i].controle = controle;
+
+        estados[i].current_setor = -1;
+        estados[i].setor_concedido = -1;
+        atomic_init(&estados[i].concessao_sinal, -1);
+        estados[i].latencia_curta_ns = 0;
+        estados[i].fracao_curta = 1024;
+        estados[i].esperas_giro = 0;
+        estados[i].esperas_bloqueio = 0;
+        estados[i].finished = false;
+        estados[i].espera_total_ns = 0;
+        estados[i].espera_max_ns = 0;
+        estados[i].cancelamento_confirmado = false;
+        estados[i].timeouts = 0;
+        estados[i].retomar_aguardando = false;
+        aleatorio_semear(&estados[i].aleatorio, aleatorio_proximo(&controle->aleatorio));
+        memoria_mutex_init(&estados[i].lock);
+
+        // Esperas com prazo usam CLOCK_MONOTONIC (imune a ajustes do relógio de parede)
+        memoria_cond_init(&estados[i].concessao_cond, true);
     }
 }
 
-void destroy_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len) {
+void destroy_aeronaves(aeronave_t* aeronaves, aeronave_estado_t* estados, size_t aeronaves_len) {
     if (aeronaves == NULL || aeronaves_len == 0) {
         return; // Nada para liberar
     }
@@ -90,15 +199,21 @@ void destroy_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len) {
 
         // Libera rota
         destruir_rota(aeronave->rota);
-        pthread_mutex_destroy(&aeronave->lock);
+        pthread_mutex_destroy(&estados[i].lock);
+        pthread_cond_destroy(&estados[i].concessao_cond);
     }
 
-    // Liberar a memória do array principal
-    // Esta chamada libera o bloco contínuo de memória que contém todas as estruturas setor_t.
-    free(aeronaves);
+    // Liberar a memória dos arrays principais (descritivo e estado quente)
+    memoria_liberar(aeronaves);
+    memoria_liberar(estados);
 }
 
 void usar_setor(aeronave_t* aeronave, setor_t* setor) {
     printf_timestamped("[AERONAVE %s] USANDO SETOR %s...\n", aeronave->id, setor->id);
-    usleep(300000 + rand() % 500000);
+    if (aeronave->controle->sem_permanencia) {
+        // Soak: só cede o processador, para que o próximo salto dispute com os demais
+        sched_yield();
+        return;
+    }
+    usleep(VOO_MIN_US + (useconds_t)aleatorio_intervalo(&aeronave->estado->aleatorio, VOO_VARIACAO_US));
 }
\ No newline at end of file
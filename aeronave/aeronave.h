@@ -3,30 +3,97 @@
 
 #include "rota.h"
 #include "setor.h"
+#include "caixa_postal.h"
+#include "utils.h"
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdatomic.h>
 
 typedef struct rota rota_t;
+typedef struct controle controle_t;
+
+// Duração do voo em um setor (usar_setor): uniforme em [VOO_MIN_US, VOO_MIN_US + VOO_VARIACAO_US)
+#define VOO_MIN_US 300000
+#define VOO_VARIACAO_US 500000
+#define VOO_MEDIO_MS ((VOO_MIN_US + VOO_VARIACAO_US / 2) / 1000)
+
+// Espera adaptativa pela concessão: a janela de giro é GIRO_FATOR vezes a latência média das
+// concessões curtas (até --giro-max-us), desde que pelo menos GIRO_FRACAO_MIN/1024 das concessões
+// recentes sejam curtas. As médias são exponenciais, com peso 1/2^GIRO_SUAVIZACAO por amostra
+#define GIRO_FATOR 2
+#define GIRO_FRACAO_MIN 256
+#define GIRO_SUAVIZACAO 3
 
 /**
- * @brief Representa uma aeronave
+ * @brief Estado mutável (quente) de uma aeronave, alterado a cada troca de setor
+ * 
+ * Fica em um vetor separado dos dados descritivos e cada elemento ocupa sua própria
+ * linha de cache, evitando falso compartilhamento entre threads de aeronaves vizinhas.
+ * 
+ * @param lock Mutex para proteger o acesso aos demais campos
+ * @param concessao_cond Condição em que a aeronave espera a concessão do banqueiro
+ * @param setor_concedido setor_index concedido pelo banqueiro e ainda não consumido (-1 se nenhum)
+ * @param espera_total_ns Tempo total de espera por setores
+ * @param espera_max_ns Maior espera individual por um setor
+ * @param current_setor setor_index do setor onde a aeronave está atualmente (-1 se nenhum)
+ * @param finished Indica se a aeronave já concluiu sua rota
+ * @param cancelamento_confirmado O banqueiro retirou a aeronave da fila após o prazo expirar (e a rota pode ter mudado)
+ * @param timeouts Solicitações de setor cujo prazo expirou
+ * @param retomar_aguardando Restaurada de um checkpoint já na fila de rota.curr: aguarda sem reenviar a solicitação
+ * @param aleatorio Gerador da própria aeronave (permanência nos setores), semeado pelo gerador do controle
+ * @param concessao_sinal Cópia de setor_concedido publicada sem o lock, observada durante o giro
+ * @param latencia_curta_ns Média móvel da latência das concessões que chegaram dentro do giro máximo
+ * @param fracao_curta Fração recente (em 1/1024) das concessões que chegaram dentro do giro máximo
+ * @param esperas_giro Esperas resolvidas sem bloquear (concessão vista durante o giro)
+ * @param esperas_bloqueio Esperas não resolvidas no giro (seguem para a variável de condição)
+ * @param msg_solicitacao Mensagem reutilizada para solicitar setores ao controle
+ * @param msg_liberacao Mensagem reutilizada para avisar a saída de setores
+ * @param msg_controle Mensagem de admissão/aposentadoria do slot (operação contínua)
+ * @param msg_cancelamento Mensagem de cancelamento de uma solicitação com prazo expirado
+ */
+typedef struct aeronave_estado {
+    pthread_mutex_t lock;
+    pthread_cond_t concessao_cond;
+    int setor_concedido;
+    long long espera_total_ns;
+    long long espera_max_ns;
+    int current_setor;
+    bool finished;
+    bool cancelamento_confirmado;
+    unsigned int timeouts;
+    bool retomar_aguardando;
+    aleatorio_t aleatorio;
+    atomic_int concessao_sinal;
+    long long latencia_curta_ns;
+    unsigned int fracao_curta;
+    unsigned int esperas_giro;
+    unsigned int esperas_bloqueio;
+
+    mensagem_t msg_solicitacao;
+    mensagem_t msg_liberacao;
+    mensagem_t msg_controle;
+    mensagem_t msg_cancelamento;
+} ALINHADO_CACHE aeronave_estado_t;
+
+/**
+ * @brief Representa uma aeronave (dados descritivos, raramente alterados)
  * 
  * @param id Identificação da nave
  * @param prioridade Prioridade da nave no setor, quanto maior mais prioridade
- * @param rota A rota que a nave deve percorrer
  * @param aero_index O ID da aeronave na matriz do banqueiro
- * @param current_setor Ponteiro para o setor onde a aeronave está atualmente
- * @param finished Indica se a aeronave já concluiu sua rota
- * @param lock Mutex para proteger o acesso à variável finished e current_setor
+ * @param rota A rota que a nave deve percorrer
+ * @param chegada_ns Instante de chegada ao sistema (CLOCK_MONOTONIC, operação contínua)
+ * @param estado Ponteiro para o estado quente da aeronave
+ * @param controle Ponteiro para o controle global
  */
 typedef struct aeronave {
     char* id;
     unsigned int prioridade;
-    rota_t rota;
     int aero_index;
-    bool finished;
-    long long espera_total_ns;
-    setor_t* current_setor;
-    pthread_mutex_t lock;
+    rota_t rota;
+    long long chegada_ns;
+    aeronave_estado_t* estado;
+    controle_t* controle;
 } aeronave_t;
 
 /**
@@ -34,28 +101,35 @@ typedef struct aeronave {
  * 
  * @param id Identificação da nave
  * @param media_espera_ms Média de tempo de espera em milissegundos
+ * @param maior_espera Maior espera individual por um setor em milissegundos
+ * @param timeouts Solicitações de setor cujo prazo expirou
  */
 typedef struct {
     char* id;
     double media_espera;
+    double maior_espera;
+    unsigned int timeouts;
 } resultado_aeronave_t;
 
 /**
  * @brief Inicializa os aeronaves em uma lista dinâmica
  * 
  * @param aeronaves lista para ser inicializada
+ * @param estados vetor (alinhado à linha de cache) com o estado quente de cada aeronave
  * @param aeronaves_len tamanho da lista
+ * @param controle controle global ao qual as aeronaves enviam mensagens
  */
-void init_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len);
+void init_aeronaves(aeronave_t* aeronaves, aeronave_estado_t* estados, size_t aeronaves_len, controle_t* controle);
 
 /**
  * @brief Libera todos os recursos internos 
  * de cada setor em um array e, em seguida, libera o próprio array.
  *
  * @param aeronaves Ponteiro para o array dinâmico de estruturas aeronave_t.
+ * @param estados Ponteiro para o array dinâmico de estados das aeronaves.
  * @param aeronaves_len O número de elementos (aeronaves) no array.
  */
-void destroy_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len);
+void destroy_aeronaves(aeronave_t* aeronaves, aeronave_estado_t* estados, size_t aeronaves_len);
 
 /**
  * @brief Função que será executado em thread onde a aeronave irá executar suas rotinas
@@ -73,6 +147,18 @@ void destroy_aeronaves(aeronave_t* aeronaves, size_t aeronaves_len);
  */
 void* aeronave_thread(void* arg);
 
+/**
+ * @brief Variante de aeronave_thread para a operação contínua
+ * 
+ * Percorre a rota e, ao final, envia MSG_APOSENTADORIA ao controle, que libera o
+ * último setor, contabiliza as estatísticas e devolve o slot para reutilização.
+ * Não retorna resultado (a thread é criada desanexada).
+ * 
+ * @param arg ponteiro para a aeronave_t do slot
+ * @return void* NULL
+ */
+void* aeronave_thread_continuo(void* arg);
+
 /**
  * @brief Simula o uso do setor pela aeronave
  * 
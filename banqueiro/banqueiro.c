@@ -0,0 +1,319 @@
+#include "banqueiro.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Layout do bloco (deslocamentos em bytes a partir do início da estrutura):
+ *   max, allocation, need, folga: n*m ints cada (linha por processo / por posição)
+ *   available, work:              m ints cada
+ *   ordem, posicao:               n ints cada
+ *   finish:                       n bytes
+ */
+struct banqueiro {
+    size_t num_processos;
+    size_t num_recursos;
+    size_t tamanho;
+    size_t off_max;
+    size_t off_allocation;
+    size_t off_need;
+    size_t off_folga;
+    size_t off_available;
+    size_t off_work;
+    size_t off_ordem;
+    size_t off_posicao;
+    size_t off_finish;
+};
+
+#define PTR(b, off) ((void*)((char*)(b) + (off)))
+#define CPTR(b, off) ((const void*)((const char*)(b) + (off)))
+
+static inline int* v_max(banqueiro_t* b) { return PTR(b, b->off_max); }
+static inline int* v_allocation(banqueiro_t* b) { return PTR(b, b->off_allocation); }
+static inline int* v_need(banqueiro_t* b) { return PTR(b, b->off_need); }
+static inline int* v_folga(banqueiro_t* b) { return PTR(b, b->off_folga); }
+static inline int* v_available(banqueiro_t* b) { return PTR(b, b->off_available); }
+static inline int* v_work(banqueiro_t* b) { return PTR(b, b->off_work); }
+static inline int* v_ordem(banqueiro_t* b) { return PTR(b, b->off_ordem); }
+static inline int* v_posicao(banqueiro_t* b) { return PTR(b, b->off_posicao); }
+static inline unsigned char* v_finish(banqueiro_t* b) { return PTR(b, b->off_finish); }
+
+static inline size_t celula(const banqueiro_t* b, int p, int r) {
+    return (size_t) p * b->num_recursos + (size_t) r;
+}
+
+static size_t arredondar(size_t x) {
+    const size_t a = sizeof(size_t);
+    return (x + a - 1) / a * a;
+}
+
+static void calcular_layout(struct banqueiro* l, size_t n, size_t m) {
+    size_t off = arredondar(sizeof(struct banqueiro));
+    size_t matriz = arredondar(n * m * sizeof(int));
+
+    l->num_processos = n;
+    l->num_recursos = m;
+    l->off_max = off; off += matriz;
+    l->off_allocation = off; off += matriz;
+    l->off_need = off; off += matriz;
+    l->off_folga = off; off += matriz;
+    l->off_available = off; off += arredondar(m * sizeof(int));
+    l->off_work = off; off += arredondar(m * sizeof(int));
+    l->off_ordem = off; off += arredondar(n * sizeof(int));
+    l->off_posicao = off; off += arredondar(n * sizeof(int));
+    l->off_finish = off; off += arredondar(n);
+    l->tamanho = off;
+}
+
+size_t banqueiro_tamanho(size_t num_processos, size_t num_recursos) {
+    struct banqueiro l;
+    calcular_layout(&l, num_processos, num_recursos);
+    return l.tamanho;
+}
+
+banqueiro_t* banqueiro_iniciar_em(void* memoria, size_t num_processos, size_t num_recursos) {
+    struct banqueiro l;
+    calcular_layout(&l, num_processos, num_recursos);
+    memset(memoria, 0, l.tamanho);
+    memcpy(memoria, &l, sizeof(l));
+    return memoria;
+}
+
+banqueiro_t* banqueiro_criar(size_t num_processos, size_t num_recursos) {
+    void* memoria = malloc(banqueiro_tamanho(num_processos, num_recursos));
+    if (memoria == NULL)
+        return NULL;
+    return banqueiro_iniciar_em(memoria, num_processos, num_recursos);
+}
+
+void banqueiro_destruir(banqueiro_t* b) {
+    free(b);
+}
+
+size_t banqueiro_num_processos(const banqueiro_t* b) { return b->num_processos; }
+size_t banqueiro_num_recursos(const banqueiro_t* b) { return b->num_recursos; }
+
+void banqueiro_definir_disponivel(banqueiro_t* b, int recurso, int quantidade) {
+    v_available(b)[recurso] = quantidade;
+}
+
+void banqueiro_definir_max(banqueiro_t* b, int processo, int recurso, int quantidade) {
+    size_t c = celula(b, processo, recurso);
+    v_max(b)[c] = quantidade;
+    v_need(b)[c] = quantidade - v_allocation(b)[c];
+}
+
+void banqueiro_definir_necessidade(banqueiro_t* b, int processo, int recurso, int quantidade) {
+    v_need(b)[celula(b, processo, recurso)] = quantidade;
+}
+
+int banqueiro_disponivel(const banqueiro_t* b, int recurso) {
+    return ((const int*) CPTR(b, b->off_available))[recurso];
+}
+
+int banqueiro_max(const banqueiro_t* b, int processo, int recurso) {
+    return ((const int*) CPTR(b, b->off_max))[celula(b, processo, recurso)];
+}
+
+int banqueiro_alocado(const banqueiro_t* b, int processo, int recurso) {
+    return ((const int*) CPTR(b, b->off_allocation))[celula(b, processo, recurso)];
+}
+
+int banqueiro_necessidade(const banqueiro_t* b, int processo, int recurso) {
+    return ((const int*) CPTR(b, b->off_need))[celula(b, processo, recurso)];
+}
+
+/**
+ * @brief Algoritmo de segurança sobre os processos dados (todos se processos == NULL).
+ * Registra a sequência encontrada em ordem[] e devolve quantos processos terminaram.
+ */
+static size_t sequencia_segura(banqueiro_t* b, const int* processos, size_t num_processos) {
+    size_t m = b->num_recursos;
+    int* work = v_work(b);
+    int* need = v_need(b);
+    int* allocation = v_allocation(b);
+    int* ordem = v_ordem(b);
+    unsigned char* finish = v_finish(b);
+    size_t terminados = 0;
+
+    memcpy(work, v_available(b), m * sizeof(int));
+    for (size_t k = 0; k < num_processos; k++)
+        finish[processos ? (size_t) processos[k] : k] = 0;
+
+    bool progresso = true;
+    while (progresso && terminados < num_processos) {
+        progresso = false;
+        for (size_t k = 0; k < num_processos; k++) {
+            size_t p = processos ? (size_t) processos[k] : k;
+            if (finish[p])
+                continue;
+
+            const int* np = need + p * m;
+            size_t r = 0;
+            while (r < m && np[r] <= work[r])
+                r++;
+            if (r < m)
+                continue;
+
+            const int* ap = allocation + p * m;
+            for (r = 0; r < m; r++)
+                work[r] += ap[r];
+            finish[p] = 1;
+            ordem[terminados++] = (int) p;
+            progresso = true;
+        }
+    }
+
+    return terminados;
+}
+
+bool banqueiro_estado_seguro(banqueiro_t* b) {
+    return sequencia_segura(b, NULL, b->num_processos) == b->num_processos;
+}
+
+bool banqueiro_subconjunto_seguro(banqueiro_t* b, const int* processos, size_t num_processos) {
+    return sequencia_segura(b, processos, num_processos) == num_processos;
+}
+
+static bool pedido_valido(banqueiro_t* b, const banqueiro_pedido_t* pedido) {
+    size_t c = celula(b, pedido->processo, pedido->recurso);
+
+    if (pedido->quantidade <= 0 || pedido->quantidade > v_need(b)[c] || pedido->quantidade > v_available(b)[pedido->recurso])
+        return false;
+    if (pedido->recurso_liberado >= 0 && v_allocation(b)[celula(b, pedido->processo, pedido->recurso_liberado)] < 1)
+        return false;
+    return true;
+}
+
+void banqueiro_aplicar(banqueiro_t* b, const banqueiro_pedido_t* pedido) {
+    size_t c = celula(b, pedido->processo, pedido->recurso);
+
+    v_available(b)[pedido->recurso] -= pedido->quantidade;
+    v_allocation(b)[c] += pedido->quantidade;
+    v_need(b)[c] -= pedido->quantidade;
+
+    if (pedido->recurso_liberado >= 0) {
+        v_available(b)[pedido->recurso_liberado] += 1;
+        v_allocation(b)[celula(b, pedido->processo, pedido->recurso_liberado)] -= 1;
+    }
+}
+
+void banqueiro_desfazer(banqueiro_t* b, const banqueiro_pedido_t* pedido) {
+    size_t c = celula(b, pedido->processo, pedido->recurso);
+
+    if (pedido->recurso_liberado >= 0) {
+        v_available(b)[pedido->recurso_liberado] -= 1;
+        v_allocation(b)[celula(b, pedido->processo, pedido->recurso_liberado)] += 1;
+    }
+
+    v_available(b)[pedido->recurso] += pedido->quantidade;
+    v_allocation(b)[c] -= pedido->quantidade;
+    v_need(b)[c] += pedido->quantidade;
+}
+
+bool banqueiro_pode_conceder(banqueiro_t* b, const banqueiro_pedido_t* pedido) {
+    if (!pedido_valido(b, pedido))
+        return false;
+
+    banqueiro_aplicar(b, pedido);
+    bool seguro = banqueiro_estado_seguro(b);
+    banqueiro_desfazer(b, pedido);
+    return seguro;
+}
+
+bool banqueiro_conceder(banqueiro_t* b, const banqueiro_pedido_t* pedido) {
+    if (!pedido_valido(b, pedido))
+        return false;
+
+    banqueiro_aplicar(b, pedido);
+    if (banqueiro_estado_seguro(b))
+        return true;
+
+    banqueiro_desfazer(b, pedido);
+    return false;
+}
+
+bool banqueiro_conceder_subconjunto(banqueiro_t* b, const banqueiro_pedido_t* pedido, const int* processos, size_t num_processos) {
+    if (!pedido_valido(b, pedido))
+        return false;
+
+    banqueiro_aplicar(b, pedido);
+    if (banqueiro_subconjunto_seguro(b, processos, num_processos))
+        return true;
+
+    banqueiro_desfazer(b, pedido);
+    return false;
+}
+
+void banqueiro_liberar(banqueiro_t* b, int processo, int recurso, int quantidade) {
+    v_allocation(b)[celula(b, processo, recurso)] -= quantidade;
+    v_available(b)[recurso] += quantidade;
+}
+
+/**
+ * @brief Pré-computa posicao[] e folga[i][r] = min_{k<i}(work_k[r] - need[s_k][r]) para a
+ * sequência segura atual. Devolve false se o estado atual não é seguro.
+ */
+static bool precomputar_folgas(banqueiro_t* b) {
+    size_t n = b->num_processos;
+    size_t m = b->num_recursos;
+
+    if (sequencia_segura(b, NULL, n) != n)
+        return false;
+
+    int* work = v_work(b);
+    int* folga = v_folga(b);
+    int* ordem = v_ordem(b);
+    int* posicao = v_posicao(b);
+    const int* need = v_need(b);
+    const int* allocation = v_allocation(b);
+
+    memcpy(work, v_available(b), m * sizeof(int));
+    for (size_t i = 0; i < n; i++) {
+        size_t p = (size_t) ordem[i];
+        int* fi = folga + i * m;
+        posicao[p] = (int) i;
+
+        for (size_t r = 0; r < m; r++) {
+            if (i == 0) {
+                /* ninguém antes: só a validade do pedido (q <= available) limita */
+                fi[r] = INT_MAX;
+            } else {
+                size_t anterior_p = (size_t) ordem[i - 1];
+                int folga_anterior = work[r] - allocation[anterior_p * m + r] - need[anterior_p * m + r];
+                int acumulada = folga[(i - 1) * m + r];
+                fi[r] = acumulada < folga_anterior ? acumulada : folga_anterior;
+            }
+        }
+
+        for (size_t r = 0; r < m; r++)
+            work[r] += allocation[p * m + r];
+    }
+
+    return true;
+}
+
+size_t banqueiro_pode_conceder_varios(banqueiro_t* b, const banqueiro_pedido_t* pedidos, size_t num_pedidos, bool* resultados) {
+    bool base_segura = precomputar_folgas(b);
+    size_t concediveis = 0;
+
+    for (size_t k = 0; k < num_pedidos; k++) {
+        const banqueiro_pedido_t* pedido = &pedidos[k];
+        bool ok;
+
+        if (!pedido_valido(b, pedido)) {
+            ok = false;
+        } else if (base_segura && v_folga(b)[(size_t) v_posicao(b)[pedido->processo] * b->num_recursos + (size_t) pedido->recurso] >= pedido->quantidade) {
+            ok = true;
+        } else {
+            ok = banqueiro_pode_conceder(b, pedido);
+        }
+
+        resultados[k] = ok;
+        if (ok)
+            concediveis++;
+    }
+
+    return concediveis;
+}
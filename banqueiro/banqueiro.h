@@ -0,0 +1,209 @@
+#ifndef BANQUEIRO_H
+#define BANQUEIRO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Estado do algoritmo do banqueiro para N processos e M recursos (biblioteca libbanqueiro.a)
+ * 
+ * Independente do simulador: não usa threads, setores nem aeronaves. O estado ocupa um
+ * único bloco contíguo e referencia seus vetores por deslocamentos relativos ao início do
+ * bloco, podendo ser copiado ou posicionado em qualquer memória (ex.: memória compartilhada).
+ * 
+ * Não é thread-safe: o chamador serializa o acesso.
+ * 
+ * Convenções:
+ * - need[p][r] é a demanda restante de p pelo recurso r;
+ * - conceder q unidades move q de available[r] para allocation[p][r] e consome q de need[p][r];
+ * - liberar devolve a alocação sem restaurar a necessidade (o processo terminou de usar o recurso).
+ */
+typedef struct banqueiro banqueiro_t;
+
+/**
+ * @brief Pedido hipotético ou real de um processo
+ * 
+ * @param processo índice do processo
+ * @param recurso índice do recurso solicitado
+ * @param quantidade unidades solicitadas (maior que zero; pedidos com quantidade <= 0 são negados)
+ * @param recurso_liberado recurso do qual o processo libera 1 unidade no mesmo passo (-1 se nenhum)
+ */
+typedef struct banqueiro_pedido {
+    int processo;
+    int recurso;
+    int quantidade;
+    int recurso_liberado;
+} banqueiro_pedido_t;
+
+/**
+ * @brief Tamanho em bytes do bloco necessário para o estado
+ * 
+ * @param num_processos 
+ * @param num_recursos 
+ * @return size_t 
+ */
+size_t banqueiro_tamanho(size_t num_processos, size_t num_recursos);
+
+/**
+ * @brief Inicializa o estado em uma memória fornecida pelo chamador (banqueiro_tamanho() bytes,
+ * alinhada para int e size_t). Todas as matrizes e disponibilidades começam zeradas.
+ * 
+ * @param memoria 
+ * @param num_processos 
+ * @param num_recursos 
+ * @return banqueiro_t* o próprio bloco
+ */
+banqueiro_t* banqueiro_iniciar_em(void* memoria, size_t num_processos, size_t num_recursos);
+
+/**
+ * @brief Aloca e inicializa um estado zerado
+ * 
+ * @param num_processos 
+ * @param num_recursos 
+ * @return banqueiro_t* ou NULL em falha de alocação
+ */
+banqueiro_t* banqueiro_criar(size_t num_processos, size_t num_recursos);
+
+/**
+ * @brief Libera um estado criado com banqueiro_criar
+ * 
+ * @param b 
+ */
+void banqueiro_destruir(banqueiro_t* b);
+
+size_t banqueiro_num_processos(const banqueiro_t* b);
+size_t banqueiro_num_recursos(const banqueiro_t* b);
+
+/**
+ * @brief Define as unidades livres do recurso (instâncias totais menos as já alocadas)
+ * 
+ * @param b 
+ * @param recurso 
+ * @param quantidade 
+ */
+void banqueiro_definir_disponivel(banqueiro_t* b, int recurso, int quantidade);
+
+/**
+ * @brief Define a demanda máxima de um processo por um recurso; need passa a ser max - allocation
+ * 
+ * @param b 
+ * @param processo 
+ * @param recurso 
+ * @param quantidade 
+ */
+void banqueiro_definir_max(banqueiro_t* b, int processo, int recurso, int quantidade);
+
+/**
+ * @brief Define diretamente a necessidade restante (max não muda); usado para restaurar
+ * linhas em que a necessidade já foi consumida (need < max - allocation)
+ * 
+ * @param b 
+ * @param processo 
+ * @param recurso 
+ * @param quantidade 
+ */
+void banqueiro_definir_necessidade(banqueiro_t* b, int processo, int recurso, int quantidade);
+
+int banqueiro_disponivel(const banqueiro_t* b, int recurso);
+int banqueiro_max(const banqueiro_t* b, int processo, int recurso);
+int banqueiro_alocado(const banqueiro_t* b, int processo, int recurso);
+int banqueiro_necessidade(const banqueiro_t* b, int processo, int recurso);
+
+/**
+ * @brief Algoritmo de segurança sobre o estado atual
+ * 
+ * @param b 
+ * @return true se existe uma sequência em que todos os processos terminam
+ */
+bool banqueiro_estado_seguro(banqueiro_t* b);
+
+/**
+ * @brief Algoritmo de segurança restrito a um subconjunto de processos
+ * 
+ * Correto quando os processos fora do subconjunto não compartilham recursos com ele
+ * (ex.: componentes de conflito), pois então não afetam nem são afetados pela sequência.
+ * 
+ * @param b 
+ * @param processos índices dos processos considerados
+ * @param num_processos tamanho do subconjunto
+ * @return true se o subconjunto está em estado seguro
+ */
+bool banqueiro_subconjunto_seguro(banqueiro_t* b, const int* processos, size_t num_processos);
+
+/**
+ * @brief Verifica se o pedido é válido e deixa o estado seguro, sem aplicá-lo
+ * 
+ * @param b 
+ * @param pedido 
+ * @return true se o pedido pode ser concedido
+ */
+bool banqueiro_pode_conceder(banqueiro_t* b, const banqueiro_pedido_t* pedido);
+
+/**
+ * @brief Concede o pedido se for seguro
+ * 
+ * @param b 
+ * @param pedido 
+ * @return true se foi concedido (estado alterado)
+ */
+bool banqueiro_conceder(banqueiro_t* b, const banqueiro_pedido_t* pedido);
+
+/**
+ * @brief Concede o pedido se o subconjunto de processos continuar seguro
+ * 
+ * Os processos fora do subconjunto não podem compartilhar recursos com ele
+ * (ver banqueiro_subconjunto_seguro); o solicitante deve pertencer ao subconjunto.
+ * 
+ * @param b 
+ * @param pedido 
+ * @param processos índices dos processos considerados
+ * @param num_processos tamanho do subconjunto
+ * @return true se foi concedido (estado alterado)
+ */
+bool banqueiro_conceder_subconjunto(banqueiro_t* b, const banqueiro_pedido_t* pedido, const int* processos, size_t num_processos);
+
+/**
+ * @brief Aplica o pedido sem checar a segurança (o chamador garante a validade)
+ * 
+ * @param b 
+ * @param pedido 
+ */
+void banqueiro_aplicar(banqueiro_t* b, const banqueiro_pedido_t* pedido);
+
+/**
+ * @brief Desfaz banqueiro_aplicar(pedido)
+ * 
+ * @param b 
+ * @param pedido 
+ */
+void banqueiro_desfazer(banqueiro_t* b, const banqueiro_pedido_t* pedido);
+
+/**
+ * @brief Libera unidades alocadas ao processo (a necessidade não é restaurada)
+ * 
+ * @param b 
+ * @param processo 
+ * @param recurso 
+ * @param quantidade 
+ */
+void banqueiro_liberar(banqueiro_t* b, int processo, int recurso, int quantidade);
+
+/**
+ * @brief Avalia vários pedidos hipotéticos, cada um isoladamente, contra o estado atual
+ * 
+ * Uma única pré-computação é compartilhada: a sequência segura do estado atual e, para
+ * cada recurso r, a folga mínima min(work_k[r] - need[s_k][r]) acumulada ao longo da
+ * sequência. Um pedido de q unidades de r pelo processo p (na posição i da sequência) só
+ * altera o trabalho disponível antes de p em -q, e depois de p a sequência é idêntica;
+ * logo, se a folga acumulada até i for >= q o pedido é seguro em O(1). Caso contrário
+ * (ou se o estado atual não for seguro) o algoritmo completo é executado para o pedido.
+ * 
+ * @param b 
+ * @param pedidos vetor de pedidos
+ * @param num_pedidos 
+ * @param resultados saída: resultados[k] indica se pedidos[k] pode ser concedido
+ * @return size_t número de pedidos concedíveis
+ */
+size_t banqueiro_pode_conceder_varios(banqueiro_t* b, const banqueiro_pedido_t* pedidos, size_t num_pedidos, bool* resultados);
+
+#endif
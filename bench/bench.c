@@ -0,0 +1,363 @@
+#define _GNU_SOURCE // syscall() para perf_event_open
+#include "controle.h"
+#include "setor.h"
+#include "aeronave.h"
+#include "rota.h"
+#include "config.h"
+#include "utils.h"
+
+#include <math.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Microbenchmarks dos kernels do controle, isolados das threads do simulador.
+ * 
+ * Cada kernel roda sobre um estado sintético do banqueiro (rotas aleatórias, cada aeronave
+ * no primeiro setor concedido com segurança), com aquecimento e várias repetições. Para cada
+ * repetição mede-se ns/op; o relatório traz média, desvio padrão e mínimo entre repetições e,
+ * quando perf_event_open está disponível, ciclos, instruções e falhas de cache/desvio por op.
+ * Antes das medições, a consulta em lote (pode_conceder_varios) é conferida pedido a pedido
+ * contra tenta_conceder_seguro; uma divergência faz o binário terminar com código 1.
+ * 
+ * Uso: controle_aereo_bench [repeticoes] [ops_por_repeticao]
+ */
+
+#define NUM_CONTADORES 4
+
+static const char* nomes_contadores[NUM_CONTADORES] = { "ciclos", "instr", "cache-miss", "branch-miss" };
+
+typedef struct contadores {
+    int fd[NUM_CONTADORES];
+    bool disponivel;
+} contadores_t;
+
+#ifdef __linux__
+static int abrir_contador(unsigned long long config, int grupo) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = grupo == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, grupo, 0);
+}
+#endif
+
+static void contadores_abrir(contadores_t* c) {
+    c->disponivel = false;
+    for (int k = 0; k < NUM_CONTADORES; k++) c->fd[k] = -1;
+
+#ifdef __linux__
+    static const unsigned long long eventos[NUM_CONTADORES] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    c->fd[0] = abrir_contador(eventos[0], -1);
+    if (c->fd[0] < 0) return;
+    for (int k = 1; k < NUM_CONTADORES; k++) {
+        c->fd[k] = abrir_contador(eventos[k], c->fd[0]);
+        if (c->fd[k] < 0) {
+            for (int j = 0; j < k; j++) close(c->fd[j]);
+            c->fd[0] = -1;
+            return;
+        }
+    }
+    c->disponivel = true;
+#endif
+}
+
+static void contadores_fechar(contadores_t* c) {
+    for (int k = 0; k < NUM_CONTADORES; k++) {
+        if (c->fd[k] >= 0) close(c->fd[k]);
+    }
+}
+
+static void contadores_iniciar(contadores_t* c) {
+#ifdef __linux__
+    if (!c->disponivel) return;
+    ioctl(c->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(c->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+// Acumula os valores do grupo em `total`
+static void contadores_parar(contadores_t* c, unsigned long long total[NUM_CONTADORES]) {
+#ifdef __linux__
+    if (!c->disponivel) return;
+    ioctl(c->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    unsigned long long leitura[1 + NUM_CONTADORES];
+    if (read(c->fd[0], leitura, sizeof(leitura)) == (ssize_t)sizeof(leitura)) {
+        for (int k = 0; k < NUM_CONTADORES; k++) total[k] += leitura[1 + k];
+    }
+#else
+    (void)total;
+#endif
+}
+
+// ---------------------------------------------------------------------
+// Estado sintético
+// ---------------------------------------------------------------------
+
+typedef struct cenario {
+    size_t num_aeronaves;
+    size_t num_setores;
+    controle_t ctrl;
+    setor_t* setores;
+    aeronave_t* aeronaves;
+    aeronave_estado_t* estados;
+    banqueiro_pedido_t* pedidos; // um pedido de próximo setor por aeronave
+    bool* resultados; // saída de banqueiro_pode_conceder_varios
+} cenario_t;
+
+static void cenario_criar(cenario_t* c, size_t num_aeronaves, size_t num_setores) {
+    config_t config;
+    memset(&config, 0, sizeof(config));
+    config.politica = POLITICA_PRIORIDADE;
+    config.semente = 12345;
+
+    c->num_aeronaves = num_aeronaves;
+    c->num_setores = num_setores;
+    init_controle(&c->ctrl, num_aeronaves, num_setores, &config);
+
+    c->setores = (setor_t*)alocar_alinhado(num_setores, sizeof(setor_t));
+    init_setores(c->setores, num_setores, &c->ctrl);
+
+    c->aeronaves = (aeronave_t*)malloc(num_aeronaves * sizeof(aeronave_t));
+    c->estados = (aeronave_estado_t*)alocar_alinhado(num_aeronaves, sizeof(aeronave_estado_t));
+    init_aeronaves(c->aeronaves, c->estados, num_aeronaves, &c->ctrl);
+    c->ctrl.aeronaves = c->aeronaves;
+    c->ctrl.estados = c->estados;
+
+    size_t rota_len = num_setores < 8 ? num_setores : 8;
+    for (size_t p = 0; p < num_aeronaves; p++) {
+        c->aeronaves[p].rota = criar_rota(c->setores, num_setores, rota_len, &c->ctrl.aleatorio);
+        controle_definir_demanda(&c->ctrl, (int)p, &c->aeronaves[p].rota);
+    }
+
+    // Cada aeronave tenta entrar no primeiro setor da rota (somente concessões seguras)
+    for (size_t p = 0; p < num_aeronaves; p++) {
+        setor_t* primeiro = rota_next_setor(&c->aeronaves[p].rota);
+        if (setor_tenta_conceder_seguro(&c->ctrl, (int)p, primeiro->setor_index, -1)) {
+            c->ctrl.setor_ocupado[p] = primeiro->setor_index;
+        } else {
+            c->aeronaves[p].rota.curr = c->aeronaves[p].rota.head;
+        }
+    }
+    controle_reconstruir_componentes(&c->ctrl);
+
+    c->pedidos = (banqueiro_pedido_t*)malloc(num_aeronaves * sizeof(banqueiro_pedido_t));
+    for (size_t p = 0; p < num_aeronaves; p++) {
+        setor_t* prox = rota_peek_setor(&c->aeronaves[p].rota);
+        c->pedidos[p].processo = (int)p;
+        c->pedidos[p].recurso = prox != NULL ? prox->setor_index : c->ctrl.setor_ocupado[p];
+        c->pedidos[p].quantidade = 1;
+        c->pedidos[p].recurso_liberado = c->ctrl.setor_ocupado[p];
+    }
+    c->resultados = (bool*)malloc(num_aeronaves * sizeof(bool));
+}
+
+static void cenario_destruir(cenario_t* c) {
+    free(c->pedidos);
+    free(c->resultados);
+    destroy_setores(c->setores, c->num_setores);
+    destroy_aeronaves(c->aeronaves, c->estados, c->num_aeronaves);
+    destroy_controle(&c->ctrl);
+}
+
+// ---------------------------------------------------------------------
+// Kernels (uma operação por chamada)
+// ---------------------------------------------------------------------
+
+static volatile long sorvedouro; // impede que o compilador descarte resultados
+
+static void op_is_safe(cenario_t* c, size_t i) {
+    (void)i;
+    sorvedouro += is_safe(&c->ctrl);
+}
+
+static void op_tenta_conceder(cenario_t* c, size_t i) {
+    const banqueiro_pedido_t* pedido = &c->pedidos[i % c->num_aeronaves];
+
+    // Concessões bem-sucedidas são desfeitas para manter o estado estável entre operações
+    if (setor_tenta_conceder_seguro(&c->ctrl, pedido->processo, pedido->recurso, pedido->recurso_liberado)) {
+        banqueiro_desfazer(c->ctrl.banqueiro, pedido);
+        sorvedouro++;
+    }
+}
+
+// Todos os pedidos do cenário de uma vez (uma operação = um lote de num_aeronaves pedidos)
+static void op_conceder_varios(cenario_t* c, size_t i) {
+    (void)i;
+    sorvedouro += (long)banqueiro_pode_conceder_varios(c->ctrl.banqueiro, c->pedidos, c->num_aeronaves, c->resultados);
+}
+
+// A consulta em lote deve responder o mesmo que a checagem de cada pedido isolado
+static bool conferir_conceder_varios(cenario_t* c) {
+    banqueiro_pode_conceder_varios(c->ctrl.banqueiro, c->pedidos, c->num_aeronaves, c->resultados);
+
+    bool ok = true;
+    for (size_t p = 0; p < c->num_aeronaves; p++) {
+        const banqueiro_pedido_t* pedido = &c->pedidos[p];
+        bool seguro = setor_tenta_conceder_seguro(&c->ctrl, pedido->processo, pedido->recurso, pedido->recurso_liberado);
+        if (seguro) banqueiro_desfazer(c->ctrl.banqueiro, pedido);
+        if (seguro != c->resultados[p]) {
+            fprintf(stderr, "ERRO: pode_conceder_varios diverge de tenta_conceder_seguro no pedido %zu (%zu x %zu): %d != %d\n",
+                    p, c->num_aeronaves, c->num_setores, c->resultados[p], seguro);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void op_fila(cenario_t* c, size_t i) {
+    // Fila do setor 0 mantida com metade da frota; a outra metade entra e sai
+    size_t metade = c->num_aeronaves / 2;
+    aeronave_t* aero = &c->aeronaves[metade + i % (c->num_aeronaves - metade)];
+    entrar_fila(&c->setores[0], aero);
+    sair_fila(&c->setores[0], aero);
+}
+
+static void op_criar_rota(cenario_t* c, size_t i) {
+    (void)i;
+    size_t rota_len = c->num_setores < 8 ? c->num_setores : 8;
+    rota_t rota = criar_rota(c->setores, c->num_setores, rota_len, &c->ctrl.aleatorio);
+    sorvedouro += (long)rota.len;
+    destruir_rota(rota);
+}
+
+static void op_printf(cenario_t* c, size_t i) {
+    printf_timestamped("[BENCH] Aeronave %s solicitou o setor %s (%zu)\n", c->aeronaves[0].id, c->setores[0].id, i);
+}
+
+static void preparar_fila(cenario_t* c) {
+    for (size_t p = 0; p < c->num_aeronaves / 2; p++) {
+        entrar_fila(&c->setores[0], &c->aeronaves[p]);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Medição
+// ---------------------------------------------------------------------
+
+typedef void (*kernel_t)(cenario_t*, size_t);
+
+static void medir(const char* nome, cenario_t* c, kernel_t kernel, size_t repeticoes, size_t ops, contadores_t* cont) {
+    // Aquecimento: caches, preditores e alocador
+    for (size_t i = 0; i < ops; i++) kernel(c, i);
+
+    double soma = 0, soma_quad = 0, minimo = -1;
+    unsigned long long total[NUM_CONTADORES] = { 0 };
+
+    for (size_t r = 0; r < repeticoes; r++) {
+        contadores_iniciar(cont);
+        long long inicio_ns = tempo_monotonico_ns();
+        for (size_t i = 0; i < ops; i++) kernel(c, i);
+        long long fim_ns = tempo_monotonico_ns();
+        contadores_parar(cont, total);
+
+        double ns_op = (double)(fim_ns - inicio_ns) / (double)ops;
+        soma += ns_op;
+        soma_quad += ns_op * ns_op;
+        if (minimo < 0 || ns_op < minimo) minimo = ns_op;
+    }
+
+    double media = soma / (double)repeticoes;
+    double variancia = soma_quad / (double)repeticoes - media * media;
+    double desvio = variancia > 0 ? sqrt(variancia) : 0.0;
+
+    fprintf(stderr, "%-22s %6zu x %-5zu %12.1f %10.1f %12.1f", nome, c->num_aeronaves, c->num_setores, media, desvio, minimo);
+    if (cont->disponivel) {
+        double total_ops = (double)(repeticoes * ops);
+        for (int k = 0; k < NUM_CONTADORES; k++) {
+            fprintf(stderr, " %12.1f", (double)total[k] / total_ops);
+        }
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    size_t repeticoes = argc > 1 ? (size_t)atol(argv[1]) : 10;
+    size_t ops = argc > 2 ? (size_t)atol(argv[2]) : 2000;
+    if (repeticoes == 0 || ops == 0) {
+        fprintf(stderr, "Uso: %s [repeticoes] [ops_por_repeticao]\n", argv[0]);
+        return 1;
+    }
+
+    contadores_t cont;
+    contadores_abrir(&cont);
+
+    // O relatório vai para stderr: stdout é redirecionado para /dev/null no kernel de log
+    fprintf(stderr, "Repetições: %zu | ops por repetição: %zu | contadores de hardware: %s\n",
+            repeticoes, ops, cont.disponivel ? "sim" : "indisponíveis");
+    fprintf(stderr, "%-22s %14s %12s %10s %12s", "kernel", "aero x setor", "ns/op", "desvio", "mín");
+    if (cont.disponivel) {
+        for (int k = 0; k < NUM_CONTADORES; k++) fprintf(stderr, " %12s", nomes_contadores[k]);
+    }
+    fprintf(stderr, "\n");
+
+    static const size_t tamanhos[][2] = { { 16, 8 }, { 64, 32 }, { 256, 64 }, { 1024, 128 } };
+    size_t num_tamanhos = sizeof(tamanhos) / sizeof(tamanhos[0]);
+
+    definir_log_habilitado(false);
+    bool conferido = true;
+    for (size_t t = 0; t < num_tamanhos; t++) {
+        cenario_t c;
+        cenario_criar(&c, tamanhos[t][0], tamanhos[t][1]);
+        conferido = conferir_conceder_varios(&c) && conferido;
+
+        // Kernels O(n^2 m) com menos operações nos tamanhos grandes
+        size_t ops_banqueiro = ops / (1 + tamanhos[t][0] / 64);
+        if (ops_banqueiro == 0) ops_banqueiro = 1;
+        medir("is_safe", &c, op_is_safe, repeticoes, ops_banqueiro, &cont);
+        medir("tenta_conceder_seguro", &c, op_tenta_conceder, repeticoes, ops_banqueiro, &cont);
+        // Um lote avalia a frota inteira: ainda menos operações
+        size_t ops_lote = ops_banqueiro / (1 + tamanhos[t][0] / 16);
+        if (ops_lote == 0) ops_lote = 1;
+        medir("pode_conceder_varios", &c, op_conceder_varios, repeticoes, ops_lote, &cont);
+
+        preparar_fila(&c);
+        medir("entrar_fila+sair_fila", &c, op_fila, repeticoes, ops, &cont);
+        medir("criar_rota", &c, op_criar_rota, repeticoes, ops, &cont);
+
+        cenario_destruir(&c);
+    }
+
+    // printf_timestamped: desabilitado (custo do teste) e habilitado com saída descartada
+    cenario_t c;
+    cenario_criar(&c, 16, 8);
+    medir("printf_ts (desligado)", &c, op_printf, repeticoes, ops, &cont);
+
+    fflush(stdout);
+    int stdout_original = dup(STDOUT_FILENO);
+    int nulo = open("/dev/null", O_WRONLY);
+    if (stdout_original >= 0 && nulo >= 0) {
+        dup2(nulo, STDOUT_FILENO);
+        definir_log_habilitado(true);
+        medir("printf_ts (ligado)", &c, op_printf, repeticoes, ops, &cont);
+        definir_log_habilitado(false);
+        fflush(stdout);
+        dup2(stdout_original, STDOUT_FILENO);
+    }
+    if (nulo >= 0) close(nulo);
+    if (stdout_original >= 0) close(stdout_original);
+
+    cenario_destruir(&c);
+    contadores_fechar(&cont);
+    return conferido ? 0 : 1;
+}
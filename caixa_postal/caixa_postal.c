@@ -0,0 +1,78 @@
+#define _POSIX_C_SOURCE 200112L // importante para sem_timedwait em semaphore.h
+#include "caixa_postal.h"
+#include "utils.h"
+#include "memoria.h"
+
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+
+void caixa_postal_init(caixa_postal_t* caixa) {
+    atomic_init(&caixa->topo, NULL);
+    // Compartilhado entre processos quando o controle está em memória compartilhada
+    sem_init(&caixa->sinal, memoria_compartilhada() ? 1 : 0, 0);
+}
+
+void caixa_postal_destroy(caixa_postal_t* caixa) {
+    if (caixa == NULL) return;
+
+    sem_destroy(&caixa->sinal);
+}
+
+void caixa_postal_reservar(mensagem_t* msg) {
+    while (atomic_load_explicit(&msg->em_transito, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+void caixa_postal_enviar(caixa_postal_t* caixa, mensagem_t* msg) {
+    atomic_store_explicit(&msg->em_transito, true, memory_order_relaxed);
+    mensagem_t* topo = atomic_load_explicit(&caixa->topo, memory_order_relaxed);
+
+    // Empilha com CAS; em caso de falha `topo` é atualizado e tentamos de novo
+    do {
+        msg->prox = topo;
+    } while (!atomic_compare_exchange_weak_explicit(&caixa->topo, &topo, msg, memory_order_release, memory_order_relaxed));
+
+    // Só a transição vazia -> não vazia precisa acordar o consumidor
+    if (topo == NULL) {
+        sem_post(&caixa->sinal);
+    }
+}
+
+mensagem_t* caixa_postal_drenar(caixa_postal_t* caixa) {
+    mensagem_t* pilha = atomic_exchange_explicit(&caixa->topo, NULL, memory_order_acquire);
+
+    // A pilha está na ordem inversa de envio, inverte para processar em ordem (FIFO)
+    mensagem_t* lista = NULL;
+    while (pilha != NULL) {
+        mensagem_t* prox = pilha->prox;
+        pilha->prox = lista;
+        lista = pilha;
+        pilha = prox;
+    }
+
+    return lista;
+}
+
+void caixa_postal_consumida(mensagem_t* msg) {
+    atomic_store_explicit(&msg->em_transito, false, memory_order_release);
+}
+
+bool caixa_postal_aguardar(caixa_postal_t* caixa, int timeout_s) {
+    struct timespec ts = get_abs_timeout(timeout_s);
+
+    while (sem_timedwait(&caixa->sinal, &ts) == -1) {
+        if (errno == ETIMEDOUT) return false;
+        // EINTR: tenta novamente
+    }
+    return true;
+}
+
+void caixa_postal_acordar(caixa_postal_t* caixa) {
+    sem_post(&caixa->sinal);
+}
+
+bool caixa_postal_vazia(caixa_postal_t* caixa) {
+    return atomic_load_explicit(&caixa->topo, memory_order_acquire) == NULL;
+}
@@ -0,0 +1,136 @@
+#ifndef CAIXA_POSTAL_H
+#define CAIXA_POSTAL_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <semaphore.h>
+
+/**
+ * @brief Tipos de mensagem enviados pelas aeronaves ao controle
+ * 
+ * MSG_SOLICITACAO: a aeronave pede entrada no setor (entra na fila do setor)
+ * MSG_LIBERACAO: a aeronave saiu do setor
+ * MSG_ADMISSAO: uma nova aeronave ocupou o slot (operação contínua), registra sua demanda
+ * MSG_APOSENTADORIA: a aeronave concluiu a rota; libera o que detém e devolve o slot
+ * MSG_CANCELAMENTO: o prazo da solicitação expirou; sai da fila do setor (se ainda não concedido) e reencaminha
+ * MSG_ENTRADA_ESCALA: a aeronave entrou no setor pelo seu bilhete da escala (já seguro); o banqueiro só registra
+ */
+typedef enum mensagem_tipo {
+    MSG_SOLICITACAO = 0,
+    MSG_LIBERACAO,
+    MSG_ADMISSAO,
+    MSG_APOSENTADORIA,
+    MSG_ENTRADA_ESCALA,
+    MSG_CANCELAMENTO
+} mensagem_tipo_t;
+
+/**
+ * @brief Mensagem de uma aeronave para o controle
+ * 
+ * As mensagens não são alocadas dinamicamente: cada aeronave possui as suas
+ * (uma por tipo) e só as reutiliza depois que o controle as consumiu. O remetente
+ * garante isso com caixa_postal_reservar() antes de preencher a mensagem: dois envios
+ * seguidos da mesma mensagem sem consumo no meio (a liberação do penúltimo e do último
+ * setor, entradas seguidas pela escala) encadeariam a mensagem nela mesma.
+ * 
+ * @param tipo tipo da mensagem
+ * @param aero_index aero_index da aeronave remetente
+ * @param setor_index setor_index do setor alvo
+ * @param prox encadeamento interno da caixa postal
+ * @param em_transito enviada e ainda não consumida pelo controle
+ */
+typedef struct mensagem {
+    mensagem_tipo_t tipo;
+    int aero_index;
+    int setor_index;
+    struct mensagem* prox;
+    atomic_bool em_transito;
+} mensagem_t;
+
+/**
+ * @brief Caixa postal MPSC (vários produtores, um consumidor) sem locks
+ * 
+ * Os produtores empilham com CAS; o consumidor retira a pilha inteira de uma vez
+ * com uma troca atômica e a inverte, recuperando a ordem de envio. O semáforo
+ * acorda o consumidor apenas quando a caixa passa de vazia para não vazia.
+ * 
+ * @param topo topo da pilha de mensagens pendentes
+ * @param sinal semáforo para o consumidor dormir enquanto a caixa está vazia
+ */
+typedef struct caixa_postal {
+    _Atomic(mensagem_t*) topo;
+    sem_t sinal;
+} caixa_postal_t;
+
+/**
+ * @brief Inicializa uma caixa postal vazia
+ * 
+ * @param caixa 
+ */
+void caixa_postal_init(caixa_postal_t* caixa);
+
+/**
+ * @brief Libera os recursos da caixa postal (as mensagens pertencem aos remetentes)
+ * 
+ * @param caixa 
+ */
+void caixa_postal_destroy(caixa_postal_t* caixa);
+
+/**
+ * @brief Aguarda o controle consumir o envio anterior da mensagem (chamar antes de preenchê-la)
+ * 
+ * Retorna imediatamente no caso comum: entre dois envios da mesma mensagem costuma haver
+ * uma concessão, que só acontece depois do consumo.
+ * 
+ * @param msg 
+ */
+void caixa_postal_reservar(mensagem_t* msg);
+
+/**
+ * @brief Envia uma mensagem (sem bloquear, seguro para várias threads)
+ * 
+ * @param caixa 
+ * @param msg mensagem reservada e preenchida pelo remetente
+ */
+void caixa_postal_enviar(caixa_postal_t* caixa, mensagem_t* msg);
+
+/**
+ * @brief Retira todas as mensagens pendentes (somente o consumidor)
+ * 
+ * @param caixa 
+ * @return mensagem_t* lista encadeada por `prox` na ordem de envio, ou NULL se vazia
+ */
+mensagem_t* caixa_postal_drenar(caixa_postal_t* caixa);
+
+/**
+ * @brief Devolve a mensagem ao remetente (somente o consumidor, depois de ler `prox` e os campos)
+ * 
+ * @param msg 
+ */
+void caixa_postal_consumida(mensagem_t* msg);
+
+/**
+ * @brief Bloqueia o consumidor até haver mensagens ou até o timeout
+ * 
+ * @param caixa 
+ * @param timeout_s tempo máximo de espera em segundos
+ * @return true se foi acordado por um envio
+ * @return false se o timeout foi atingido
+ */
+bool caixa_postal_aguardar(caixa_postal_t* caixa, int timeout_s);
+
+/**
+ * @brief Acorda o consumidor sem enviar mensagem (ex.: pedido de encerramento)
+ * 
+ * @param caixa 
+ */
+void caixa_postal_acordar(caixa_postal_t* caixa);
+
+/**
+ * @brief Indica se não há mensagens pendentes (instantâneo; só é estável se os remetentes estiverem parados)
+ * @param caixa 
+ * @return true se a caixa está vazia
+ */
+bool caixa_postal_vazia(caixa_postal_t* caixa);
+
+#endif
@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200112L // importante para fsync e fileno
+#include "checkpoint.h"
+#include "aeronave.h"
+#include "setor.h"
+#include "rota.h"
+#include "banqueiro.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Buffer do fluxo de escrita/leitura: poucas chamadas de sistema mesmo com frotas grandes
+#define TAMANHO_BUFFER (1 << 20)
+
+// Nome do arquivo temporário da gravação (o do checkpoint com o sufixo .tmp)
+#define TAMANHO_NOME 4096
+
+// Fase da aeronave no instante do checkpoint
+enum {
+    FASE_ESTACIONADA = 0, // no início de um salto (ou ainda não iniciou a rota)
+    FASE_NA_FILA,         // aguardando a concessão do setor em que está na fila
+    FASE_CONCLUIDA
+};
+
+// Fluxo com erro acumulado: a falha é verificada uma vez no final
+typedef struct fluxo {
+    FILE* f;
+    bool ok;
+} fluxo_t;
+
+static void escrever(fluxo_t* fl, const void* dados, size_t tamanho) {
+    if (fl->ok && fwrite(dados, tamanho, 1, fl->f) != 1) fl->ok = false;
+}
+
+static void escrever_i32(fluxo_t* fl, int32_t v) { escrever(fl, &v, sizeof(v)); }
+static void escrever_i64(fluxo_t* fl, int64_t v) { escrever(fl, &v, sizeof(v)); }
+
+static void ler(fluxo_t* fl, void* dados, size_t tamanho) {
+    if (fl->ok && fread(dados, tamanho, 1, fl->f) != 1) fl->ok = false;
+}
+
+static int32_t ler_i32(fluxo_t* fl) { int32_t v = 0; ler(fl, &v, sizeof(v)); return v; }
+static int64_t ler_i64(fluxo_t* fl) { int64_t v = 0; ler(fl, &v, sizeof(v)); return v; }
+
+// Posição de um nó na rota (len se NULL: rota percorrida)
+static int32_t indice_no(const rota_t* rota, const rota_node_t* no) {
+    int32_t i = 0;
+    for (rota_node_t* curr = rota->head; curr != NULL && curr != no; curr = curr->next) i++;
+    return i;
+}
+
+bool checkpoint_gravar(controle_t* ctrl, const char* arquivo) {
+    char temporario[TAMANHO_NOME];
+    if (snprintf(temporario, sizeof(temporario), "%s.tmp", arquivo) >= (int)sizeof(temporario)) {
+        fprintf(stderr, "ERRO: nome do arquivo de checkpoint longo demais: %s\n", arquivo);
+        return false;
+    }
+
+    fluxo_t fl = { .f = fopen(temporario, "wb"), .ok = true };
+    if (fl.f == NULL) {
+        perror(temporario);
+        return false;
+    }
+    setvbuf(fl.f, NULL, _IOFBF, TAMANHO_BUFFER);
+
+    size_t n = ctrl->num_aeronaves;
+    size_t m = ctrl->num_setores;
+    banqueiro_t* b = ctrl->banqueiro;
+
+    checkpoint_cabecalho_t cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, CHECKPOINT_MAGIA, sizeof(cab.magia));
+    cab.versao = CHECKPOINT_VERSAO;
+    cab.num_aeronaves = (uint32_t)n;
+    cab.num_setores = (uint32_t)m;
+    cab.decorrido_ns = tempo_monotonico_ns() - ctrl->politica.t_inicio_ns;
+    cab.aleatorio = ctrl->aleatorio.estado;
+    cab.politica = (int32_t)ctrl->politica.tipo;
+    cab.taxa_envelhecimento = ctrl->politica.taxa_envelhecimento;
+    cab.prazo_max_ms = ctrl->politica.prazo_max_ms;
+    cab.tamanho_estatisticas = sizeof(estatisticas_operacao_t);
+    escrever(&fl, &cab, sizeof(cab));
+
+    for (size_t j = 0; j < m; j++) {
+        escrever_i32(&fl, ctrl->capacidade[j]);
+        escrever_i32(&fl, banqueiro_disponivel(b, (int)j));
+    }
+
+    for (size_t j = 0; j < m; j++) {
+        const setor_t* setor = &ctrl->setores[j];
+        escrever_i32(&fl, (int32_t)setor->fila_len);
+        for (int a = setor->fila_inicio; a != -1; a = ctrl->fila_nos[a].prox) {
+            escrever_i32(&fl, a);
+            escrever_i64(&fl, ctrl->fila_nos[a].chave);
+        }
+    }
+
+    for (size_t p = 0; p < n; p++) {
+        const aeronave_t* aero = &ctrl->aeronaves[p];
+        const aeronave_estado_t* estado = &ctrl->estados[p];
+
+        // Quem está na fila já avançou rota.curr além do setor solicitado
+        int32_t posicao = indice_no(&aero->rota, aero->rota.curr);
+        int32_t fase = FASE_ESTACIONADA;
+        if (estado->finished) {
+            fase = FASE_CONCLUIDA;
+        } else if (ctrl->fila_nos[p].setor_index != -1) {
+            fase = FASE_NA_FILA;
+            posicao--;
+        }
+
+        escrever_i32(&fl, (int32_t)aero->prioridade);
+        escrever_i32(&fl, (int32_t)aero->rota.len);
+        for (rota_node_t* curr = aero->rota.head; curr != NULL; curr = curr->next) {
+            int j = curr->setor->setor_index;
+            escrever_i32(&fl, j);
+            escrever_i32(&fl, banqueiro_max(b, (int)p, j));
+            escrever_i32(&fl, banqueiro_alocado(b, (int)p, j));
+            escrever_i32(&fl, banqueiro_necessidade(b, (int)p, j));
+        }
+        escrever_i32(&fl, posicao);
+        escrever_i32(&fl, fase);
+        escrever_i32(&fl, estado->current_setor);
+        escrever_i32(&fl, ctrl->setor_ocupado[p]);
+        escrever_i32(&fl, ctrl->aeronave_ativa[p]);
+        escrever_i64(&fl, estado->espera_total_ns);
+        escrever_i64(&fl, estado->espera_max_ns);
+        escrever_i64(&fl, (int64_t)estado->aleatorio.estado);
+    }
+
+    escrever(&fl, &ctrl->estatisticas, sizeof(ctrl->estatisticas));
+
+    // O instantâneo só substitui o anterior depois de estar inteiro no disco
+    if (fl.ok && (fflush(fl.f) != 0 || fsync(fileno(fl.f)) != 0)) fl.ok = false;
+    if (fclose(fl.f) != 0) fl.ok = false;
+    if (!fl.ok || rename(temporario, arquivo) != 0) {
+        perror(arquivo);
+        remove(temporario);
+        return false;
+    }
+
+    return true;
+}
+
+bool checkpoint_ler_cabecalho(const char* arquivo, checkpoint_cabecalho_t* cab) {
+    FILE* f = fopen(arquivo, "rb");
+    if (f == NULL) {
+        perror(arquivo);
+        return false;
+    }
+
+    bool ok = fread(cab, sizeof(*cab), 1, f) == 1;
+    fclose(f);
+
+    if (!ok || memcmp(cab->magia, CHECKPOINT_MAGIA, sizeof(cab->magia)) != 0 || cab->versao != CHECKPOINT_VERSAO ||
+        cab->tamanho_estatisticas != sizeof(estatisticas_operacao_t) || cab->num_aeronaves == 0 || cab->num_setores == 0) {
+        fprintf(stderr, "ERRO: '%s' não é um checkpoint válido desta versão.\n", arquivo);
+        return false;
+    }
+    return true;
+}
+
+bool checkpoint_restaurar(const char* arquivo, controle_t* ctrl) {
+    checkpoint_cabecalho_t cab;
+    if (!checkpoint_ler_cabecalho(arquivo, &cab)) return false;
+    if (cab.num_aeronaves != ctrl->num_aeronaves || cab.num_setores != ctrl->num_setores) return false;
+
+    fluxo_t fl = { .f = fopen(arquivo, "rb"), .ok = true };
+    if (fl.f == NULL) return false;
+    setvbuf(fl.f, NULL, _IOFBF, TAMANHO_BUFFER);
+    ler(&fl, &cab, sizeof(cab));
+
+    size_t n = ctrl->num_aeronaves;
+    size_t m = ctrl->num_setores;
+    banqueiro_t* b = ctrl->banqueiro;
+
+    // As chaves gravadas nas filas seguem a política e o relógio da execução original
+    ctrl->politica.tipo = (politica_tipo_t)cab.politica;
+    ctrl->politica.taxa_envelhecimento = cab.taxa_envelhecimento;
+    ctrl->politica.prazo_max_ms = cab.prazo_max_ms;
+    ctrl->politica.t_inicio_ns = tempo_monotonico_ns() - cab.decorrido_ns;
+
+    // Áreas de trabalho no rascunho do controle (3 * m): nada na pilha cresce com a topologia
+    int* disponivel = ctrl->rascunho;
+    int* caminho = ctrl->rascunho + m;
+    for (size_t j = 0; j < m; j++) {
+        ctrl->capacidade[j] = ler_i32(&fl);
+        disponivel[j] = ler_i32(&fl);
+        banqueiro_definir_disponivel(b, (int)j, ctrl->capacidade[j]);
+    }
+
+    for (size_t j = 0; j < m && fl.ok; j++) {
+        setor_t* setor = &ctrl->setores[j];
+        int32_t len = ler_i32(&fl);
+        for (int32_t k = 0; k < len && fl.ok; k++) {
+            int32_t a = ler_i32(&fl);
+            long long chave = ler_i64(&fl);
+            if (a < 0 || (size_t)a >= n) {
+                fl.ok = false;
+                break;
+            }
+
+            // Reencadeia na ordem gravada, sem recalcular a chave
+            fila_no_t* no = &ctrl->fila_nos[a];
+            no->chave = chave;
+            no->setor_index = (int)j;
+            no->prox = -1;
+            no->ant = setor->fila_fim;
+            if (setor->fila_fim != -1) {
+                ctrl->fila_nos[setor->fila_fim].prox = a;
+            } else {
+                setor->fila_inicio = a;
+            }
+            setor->fila_fim = a;
+            setor->fila_len++;
+        }
+    }
+
+    for (size_t p = 0; p < n && fl.ok; p++) {
+        aeronave_t* aero = &ctrl->aeronaves[p];
+        aeronave_estado_t* estado = &ctrl->estados[p];
+
+        aero->prioridade = (unsigned int)ler_i32(&fl);
+        int32_t len = ler_i32(&fl);
+        if (len < 0 || (size_t)len > m) {
+            fl.ok = false;
+            break;
+        }
+
+        for (int32_t i = 0; i < len; i++) {
+            int j = caminho[i] = ler_i32(&fl);
+            int max = ler_i32(&fl);
+            int alocado = ler_i32(&fl);
+            int necessidade = ler_i32(&fl);
+            if (j < 0 || (size_t)j >= m) {
+                fl.ok = false;
+                break;
+            }
+
+            banqueiro_definir_max(b, (int)p, j, max);
+            if (alocado > 0) {
+                banqueiro_pedido_t pedido = { .processo = (int)p, .recurso = j, .quantidade = alocado, .recurso_liberado = -1 };
+                banqueiro_aplicar(b, &pedido);
+            }
+            banqueiro_definir_necessidade(b, (int)p, j, necessidade);
+        }
+        if (!fl.ok) break;
+
+        destruir_rota(aero->rota);
+        aero->rota = criar_rota_caminho(ctrl->setores, caminho, (size_t)len);
+
+        int32_t posicao = ler_i32(&fl);
+        int32_t fase = ler_i32(&fl);
+        aero->rota.curr = aero->rota.head;
+        for (int32_t i = 0; i < posicao && aero->rota.curr != NULL; i++) {
+            aero->rota.curr = aero->rota.curr->next;
+        }
+
+        // Uma aeronave concluída já liberou o último setor: a thread só devolve o resultado
+        estado->current_setor = ler_i32(&fl);
+        if (fase == FASE_CONCLUIDA) {
+            estado->current_setor = -1;
+        }
+        estado->retomar_aguardando = fase == FASE_NA_FILA;
+        ctrl->setor_ocupado[p] = ler_i32(&fl);
+        ctrl->aeronave_ativa[p] = ler_i32(&fl) != 0;
+        estado->espera_total_ns = ler_i64(&fl);
+        estado->espera_max_ns = ler_i64(&fl);
+        aleatorio_semear(&estado->aleatorio, (uint64_t)ler_i64(&fl));
+    }
+
+    ler(&fl, &ctrl->estatisticas, sizeof(ctrl->estatisticas));
+    fclose(fl.f);
+
+    // O disponível reconstruído a partir das alocações tem de bater com o gravado
+    for (size_t j = 0; j < m && fl.ok; j++) {
+        if (banqueiro_disponivel(b, (int)j) != disponivel[j]) fl.ok = false;
+    }
+    if (!fl.ok) {
+        fprintf(stderr, "ERRO: checkpoint '%s' truncado ou inconsistente.\n", arquivo);
+        return false;
+    }
+
+    ctrl->componentes_desatualizadas = true;
+    ctrl->componentes_demanda_nova = true;
+    aleatorio_semear(&ctrl->aleatorio, cab.aleatorio);
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "controle.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Identificação e versão do formato do instantâneo
+#define CHECKPOINT_MAGIA "CKPTCA01"
+#define CHECKPOINT_VERSAO 2
+
+/**
+ * @brief Cabeçalho do instantâneo binário (modo em lote)
+ *
+ * Depois do cabeçalho vêm, nesta ordem: capacidade e disponível de cada setor; a fila de
+ * cada setor (tamanho e pares aero_index/chave na ordem da fila); para cada aeronave a
+ * prioridade, a rota como índices de setor, a posição na rota, a fase (estacionada, na
+ * fila ou concluída), o setor ocupado, as esperas acumuladas, o estado do seu gerador e as linhas max/alocado/
+ * necessidade do banqueiro restritas aos setores da rota (as demais células são zero);
+ * e por fim as estatísticas do controle. Nenhum ponteiro é gravado.
+ *
+ * @param magia CHECKPOINT_MAGIA
+ * @param versao CHECKPOINT_VERSAO
+ * @param num_aeronaves
+ * @param num_setores
+ * @param decorrido_ns tempo de simulação até o checkpoint
+ * @param aleatorio estado do gerador do controle no instante do checkpoint
+ * @param politica tipo da política das filas (as chaves gravadas seguem esta política)
+ * @param taxa_envelhecimento
+ * @param prazo_max_ms
+ * @param tamanho_estatisticas sizeof(estatisticas_operacao_t) de quem gravou
+ */
+typedef struct checkpoint_cabecalho {
+    char magia[8];
+    uint32_t versao;
+    uint32_t num_aeronaves;
+    uint32_t num_setores;
+    int64_t decorrido_ns;
+    uint64_t aleatorio;
+    int32_t politica;
+    uint32_t taxa_envelhecimento;
+    uint32_t prazo_max_ms;
+    uint32_t tamanho_estatisticas;
+} checkpoint_cabecalho_t;
+
+/**
+ * @brief Grava o instantâneo do sistema parado (executado SOMENTE pelo banqueiro, sob banker_lock)
+ *
+ * Todas as aeronaves devem estar estacionadas, na fila de um setor sem concessão pendente ou
+ * concluídas, com a caixa postal vazia. O arquivo é escrito em `arquivo`.tmp, sincronizado
+ * com fsync e renomeado, de forma que uma falha durante a escrita preserva o anterior.
+ *
+ * @param ctrl
+ * @param arquivo destino
+ * @return true em sucesso
+ */
+bool checkpoint_gravar(controle_t* ctrl, const char* arquivo);
+
+/**
+ * @brief Lê e valida o cabeçalho (dimensiona o controle antes da restauração)
+ *
+ * @param arquivo
+ * @param cab saída
+ * @return true se o arquivo é um instantâneo desta versão
+ */
+bool checkpoint_ler_cabecalho(const char* arquivo, checkpoint_cabecalho_t* cab);
+
+/**
+ * @brief Reconstrói o estado gravado sobre um controle recém-criado
+ *
+ * O controle, os setores e as aeronaves devem ter sido inicializados com as dimensões do
+ * cabeçalho. Restaura rotas e posições, filas, matrizes do banqueiro, esperas, estatísticas
+ * e os geradores do controle e das aeronaves; as aeronaves que estavam na fila voltam a aguardar a concessão sem
+ * reenviar a solicitação.
+ *
+ * @param arquivo
+ * @param ctrl
+ * @return true em sucesso; false se o arquivo estiver truncado ou inconsistente
+ */
+bool checkpoint_restaurar(const char* arquivo, controle_t* ctrl);
+
+#endif
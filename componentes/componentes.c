@@ -0,0 +1,100 @@
+#include "componentes.h"
+#include "memoria.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+bool componentes_init(componentes_t* comp, size_t num_aeronaves, size_t num_setores) {
+    size_t vertices = num_aeronaves + num_setores;
+
+    comp->num_aeronaves = num_aeronaves;
+    comp->num_setores = num_setores;
+    comp->pai = (int*)memoria_alocar(vertices, sizeof(int));
+    comp->tamanho = (int*)memoria_alocar(vertices, sizeof(int));
+    comp->inicio = (size_t*)memoria_alocar(vertices + 1, sizeof(size_t));
+    comp->membros = (int*)memoria_alocar(num_aeronaves + 1, sizeof(int));
+    if (comp->pai == NULL || comp->tamanho == NULL || comp->inicio == NULL || comp->membros == NULL) {
+        componentes_destroy(comp);
+        return false;
+    }
+
+    componentes_limpar(comp);
+    componentes_finalizar(comp);
+    return true;
+}
+
+void componentes_destroy(componentes_t* comp) {
+    memoria_liberar(comp->pai);
+    memoria_liberar(comp->tamanho);
+    memoria_liberar(comp->inicio);
+    memoria_liberar(comp->membros);
+    comp->pai = comp->tamanho = comp->membros = NULL;
+    comp->inicio = NULL;
+}
+
+void componentes_limpar(componentes_t* comp) {
+    size_t vertices = comp->num_aeronaves + comp->num_setores;
+    for (size_t v = 0; v < vertices; v++) {
+        comp->pai[v] = (int)v;
+        comp->tamanho[v] = 1;
+    }
+}
+
+static int raiz(componentes_t* comp, int v) {
+    while (comp->pai[v] != v) {
+        // Compressão de caminho por divisão ao meio
+        comp->pai[v] = comp->pai[comp->pai[v]];
+        v = comp->pai[v];
+    }
+    return v;
+}
+
+void componentes_unir(componentes_t* comp, int aero_idx, int setor_idx) {
+    int a = raiz(comp, aero_idx);
+    int b = raiz(comp, (int)comp->num_aeronaves + setor_idx);
+    if (a == b) return;
+
+    if (comp->tamanho[a] < comp->tamanho[b]) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    comp->pai[b] = a;
+    comp->tamanho[a] += comp->tamanho[b];
+}
+
+void componentes_finalizar(componentes_t* comp) {
+    size_t vertices = comp->num_aeronaves + comp->num_setores;
+
+    // Contagem das aeronaves por raiz e soma de prefixos (mesma montagem do CSR da topologia)
+    memset(comp->inicio, 0, (vertices + 1) * sizeof(size_t));
+    for (size_t p = 0; p < comp->num_aeronaves; p++) {
+        comp->inicio[raiz(comp, (int)p) + 1]++;
+    }
+
+    comp->num_componentes = 0;
+    comp->maior_componente = 0;
+    for (size_t v = 0; v < vertices; v++) {
+        size_t qtd = comp->inicio[v + 1];
+        if (qtd > 0) comp->num_componentes++;
+        if (qtd > comp->maior_componente) comp->maior_componente = qtd;
+        comp->inicio[v + 1] += comp->inicio[v];
+    }
+
+    // Preenche da última para a primeira aeronave usando inicio[r + 1] (fim da lista) como cursor
+    for (size_t p = comp->num_aeronaves; p-- > 0;) {
+        int r = raiz(comp, (int)p);
+        comp->membros[--comp->inicio[r + 1]] = (int)p;
+    }
+    // Agora inicio[r + 1] aponta para o começo da lista de r: desloca uma posição
+    for (size_t v = 0; v < vertices; v++) {
+        comp->inicio[v] = comp->inicio[v + 1];
+    }
+    comp->inicio[vertices] = comp->num_aeronaves;
+}
+
+const int* componentes_membros(componentes_t* comp, int aero_idx, size_t* len) {
+    int r = raiz(comp, aero_idx);
+    *len = comp->inicio[r + 1] - comp->inicio[r];
+    return &comp->membros[comp->inicio[r]];
+}
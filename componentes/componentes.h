@@ -0,0 +1,89 @@
+#ifndef COMPONENTES_H
+#define COMPONENTES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Componentes conexas do grafo de compartilhamento aeronave–setor
+ * 
+ * Vértices: aeronaves (0 .. num_aeronaves - 1) e setores (num_aeronaves + setor_index).
+ * Uma aresta liga a aeronave a cada setor em que ainda tem demanda ou alocação. Aeronaves
+ * de componentes distintas nunca disputam um setor, então o algoritmo de segurança pode
+ * ser executado apenas sobre a componente da aeronave solicitante.
+ * 
+ * Construção em duas fases: componentes_limpar(), componentes_unir() para cada aresta
+ * (union-find com compressão de caminho e união por tamanho) e componentes_finalizar(),
+ * que agrupa as aeronaves de cada componente em listas contíguas (formato CSR).
+ * 
+ * @param num_aeronaves 
+ * @param num_setores 
+ * @param pai floresta do union-find (num_aeronaves + num_setores)
+ * @param tamanho tamanho de cada árvore (válido nas raízes)
+ * @param inicio deslocamento da lista de membros de cada raiz (num_aeronaves + num_setores + 1)
+ * @param membros aeronaves agrupadas por componente
+ * @param num_componentes componentes com pelo menos uma aeronave (após finalizar)
+ * @param maior_componente aeronaves na maior componente (após finalizar)
+ */
+typedef struct componentes {
+    size_t num_aeronaves;
+    size_t num_setores;
+    int* pai;
+    int* tamanho;
+    size_t* inicio;
+    int* membros;
+    size_t num_componentes;
+    size_t maior_componente;
+} componentes_t;
+
+/**
+ * @brief Aloca as estruturas (todas as aeronaves começam isoladas)
+ * 
+ * @param comp 
+ * @param num_aeronaves 
+ * @param num_setores 
+ * @return true em sucesso
+ */
+bool componentes_init(componentes_t* comp, size_t num_aeronaves, size_t num_setores);
+
+/**
+ * @brief Libera a memória das componentes
+ * 
+ * @param comp 
+ */
+void componentes_destroy(componentes_t* comp);
+
+/**
+ * @brief Inicia uma reconstrução: todos os vértices voltam a ser isolados
+ * 
+ * @param comp 
+ */
+void componentes_limpar(componentes_t* comp);
+
+/**
+ * @brief Registra que a aeronave ainda usa ou precisa do setor
+ * 
+ * @param comp 
+ * @param aero_idx 
+ * @param setor_idx 
+ */
+void componentes_unir(componentes_t* comp, int aero_idx, int setor_idx);
+
+/**
+ * @brief Conclui a reconstrução, agrupando as aeronaves por componente
+ * 
+ * @param comp 
+ */
+void componentes_finalizar(componentes_t* comp);
+
+/**
+ * @brief Aeronaves da componente que contém aero_idx (inclusive ela mesma)
+ * 
+ * @param comp componentes finalizadas
+ * @param aero_idx 
+ * @param len saída: número de aeronaves
+ * @return const int* lista de aero_index
+ */
+const int* componentes_membros(componentes_t* comp, int aero_idx, size_t* len);
+
+#endif
@@ -0,0 +1,489 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+static void config_uso(const char* prog) {
+    fprintf(stderr, "Uso: %s <num_aeronaves> <num_setores> [opções]\n", prog);
+    fprintf(stderr, "Opções:\n");
+    fprintf(stderr, "  -l, --lookahead                 Solicita o próximo setor enquanto voa no atual (reserva antecipada)\n");
+    fprintf(stderr, "  -p, --politica=NOME             Ordem das filas: prioridade (padrão), envelhecimento ou prazo\n");
+    fprintf(stderr, "  -s, --selecao=NOME              Quem recebe a vaga entre as aeronaves seguras: fila (padrão), rota-curta, menos-bloqueio ou mista\n");
+    fprintf(stderr, "      --peso-prioridade=W         Peso da prioridade (0 a 1) na seleção mista (padrão: 0.5)\n");
+    fprintf(stderr, "      --taxa-envelhecimento=N     Pontos de prioridade ganhos por segundo de espera (padrão: 100; máx.: 10000)\n");
+    fprintf(stderr, "      --prazo-max-ms=N            Prazo da aeronave de prioridade 0 na política prazo (padrão: 5000)\n");
+    fprintf(stderr, "      --prazo-setor-ms=N          Prazo de cada espera por setor; ao expirar reencaminha a aeronave (padrão: 0 = sem prazo)\n");
+    fprintf(stderr, "  -q, --silencioso                Não imprime o log de eventos\n");
+    fprintf(stderr, "  -c, --continuo                  Operação contínua: <num_aeronaves> vira o número de slots simultâneos\n");
+    fprintf(stderr, "      --taxa-chegada=R            Chegadas por segundo (Poisson) no modo contínuo (padrão: 1.0)\n");
+    fprintf(stderr, "      --trace=ARQUIVO             Instantes de chegada em ms, um por linha (substitui a taxa)\n");
+    fprintf(stderr, "      --chegadas=N                Encerra após N chegadas (modo contínuo)\n");
+    fprintf(stderr, "      --duracao=S                 Encerra as chegadas após S segundos (modo contínuo)\n");
+    fprintf(stderr, "  -t, --topologia=grade|ARQUIVO   Planeja rotas sobre um grafo de setores (grade gerada ou arestas \"a b\")\n");
+    fprintf(stderr, "      --peso-contencao=W          Peso da contenção prevista no custo das rotas (padrão: 1.0; 0 = menor caminho)\n");
+    fprintf(stderr, "  -e, --escala                    Compila a ordem de entrada nos setores antes do voo e a segue\n");
+    fprintf(stderr, "      --tolerancia-escala-ms=N    Atraso de um bilhete que faz voltar ao controle online (padrão: 300)\n");
+    fprintf(stderr, "      --capacidade=N[,N...]       Aeronaves simultâneas por setor; a lista se repete pelos setores (padrão: 1)\n");
+    fprintf(stderr, "      --processos=K               Executa as aeronaves em K processos sobre memória compartilhada (modo em lote)\n");
+    fprintf(stderr, "      --checkpoint=ARQUIVO        Grava periodicamente um instantâneo da simulação (modo em lote)\n");
+    fprintf(stderr, "      --checkpoint-intervalo-ms=N Intervalo entre checkpoints (padrão: 60000)\n");
+    fprintf(stderr, "      --restaurar=ARQUIVO         Retoma a simulação de um instantâneo (dispensa <num_aeronaves> <num_setores>)\n");
+    fprintf(stderr, "      --perfil                    Mede a contenção dos locks e as fases do controlador e imprime ao final\n");
+    fprintf(stderr, "      --soak                      Permanência ~0 nos setores e verificação online das invariantes (implica -q)\n");
+    fprintf(stderr, "      --vigia-s=N                 Impasse no soak: N segundos sem concessões com aeronaves nas filas (padrão: 10; 0 = sem vigia)\n");
+    fprintf(stderr, "      --giro-max-us=N             Espera ativa máxima pela concessão antes de bloquear; adapta-se à latência (padrão: 200; 0 = bloqueia)\n");
+    fprintf(stderr, "      --semente=N                 Semente do gerador (padrão: o relógio); reproduz frota, rotas e chegadas\n");
+    fprintf(stderr, "      --comprimento-rota=N        Setores de cada rota aleatória (padrão: 0 = sorteado entre 1 e <num_setores>)\n");
+    fprintf(stderr, "Varredura (simulações em lote paralelas no mesmo processo; um resumo por ponto da grade):\n");
+    fprintf(stderr, "      --varredura                 Executa a grade; os eixos omitidos usam <num_aeronaves> <num_setores> e as opções acima\n");
+    fprintf(stderr, "      --grade-aeronaves=N[,N...]  Números de aeronaves\n");
+    fprintf(stderr, "      --grade-setores=N[,N...]    Números de setores\n");
+    fprintf(stderr, "      --grade-rota=N[,N...]       Comprimentos de rota (0 = sorteado)\n");
+    fprintf(stderr, "      --grade-politicas=P[,P...]  Políticas das filas\n");
+    fprintf(stderr, "      --grade-selecoes=S[,S...]   Seleções de concessão\n");
+    fprintf(stderr, "      --repeticoes=R              Execuções por ponto da grade, com sementes consecutivas (padrão: 1)\n");
+    fprintf(stderr, "      --trabalhos=J               Simulações ao mesmo tempo (padrão: processadores disponíveis)\n");
+}
+
+// Inteiro em [0, maximo], sem sobras no texto (atoi aceitaria lixo e um negativo viraria um
+// unsigned enorme)
+static bool parse_limitado(const char* opcao, const char* texto, long maximo, unsigned int* valor) {
+    char* fim;
+    long v = strtol(texto, &fim, 10);
+    if (fim == texto || *fim != '\0' || v < 0 || v > maximo) {
+        fprintf(stderr, "ERRO: valor inválido '%s' para --%s (inteiro entre 0 e %ld).\n", texto, opcao, maximo);
+        return false;
+    }
+    *valor = (unsigned int)v;
+    return true;
+}
+
+// Lista "N[,N...]" de inteiros positivos
+static bool parse_capacidades(const char* texto, config_t* config) {
+    size_t n = 0;
+    const char* c = texto;
+    while (true) {
+        char* fim;
+        long valor = strtol(c, &fim, 10);
+        if (fim == c || valor <= 0 || n == CONFIG_MAX_CAPACIDADES) return false;
+        config->capacidades[n++] = (unsigned int)valor;
+
+        if (*fim == '\0') break;
+        if (*fim != ',') return false;
+        c = fim + 1;
+    }
+
+    config->num_capacidades = n;
+    return true;
+}
+
+// Lista "N[,N...]" de inteiros não negativos (positivos se `minimo` for 1)
+static bool parse_lista(const char* texto, size_t* valores, size_t* num_valores, long minimo) {
+    size_t n = 0;
+    const char* c = texto;
+    while (true) {
+        char* fim;
+        long valor = strtol(c, &fim, 10);
+        if (fim == c || valor < minimo || n == CONFIG_MAX_GRADE) return false;
+        valores[n++] = (size_t)valor;
+
+        if (*fim == '\0') break;
+        if (*fim != ',') return false;
+        c = fim + 1;
+    }
+
+    *num_valores = n;
+    return true;
+}
+
+// Lista "P[,P...]" de nomes de política
+static bool parse_politicas(const char* texto, config_t* config) {
+    char copia[strlen(texto) + 1];
+    strcpy(copia, texto);
+
+    size_t n = 0;
+    char* contexto;
+    for (char* nome = strtok_r(copia, ",", &contexto); nome != NULL; nome = strtok_r(NULL, ",", &contexto)) {
+        if (n == CONFIG_MAX_GRADE || !politica_parse(nome, &config->grade_politicas[n])) return false;
+        n++;
+    }
+
+    config->num_grade_politicas = n;
+    return n > 0;
+}
+
+// Lista "S[,S...]" de nomes de seleção
+static bool parse_selecoes(const char* texto, config_t* config) {
+    char copia[strlen(texto) + 1];
+    strcpy(copia, texto);
+
+    size_t n = 0;
+    char* contexto;
+    for (char* nome = strtok_r(copia, ",", &contexto); nome != NULL; nome = strtok_r(NULL, ",", &contexto)) {
+        if (n == CONFIG_MAX_GRADE || !selecao_parse(nome, &config->grade_selecoes[n])) return false;
+        n++;
+    }
+
+    config->num_grade_selecoes = n;
+    return n > 0;
+}
+
+bool config_parse(config_t* config, int argc, char** argv) {
+    // Valores padrão
+    config->num_aeronaves = 0;
+    config->num_setores = 0;
+    config->lookahead = false;
+    config->politica = POLITICA_PRIORIDADE;
+    config->selecao = SELECAO_FILA;
+    config->peso_prioridade = 0.5;
+    config->taxa_envelhecimento = 100;
+    config->prazo_max_ms = 5000;
+    config->prazo_setor_ms = 0;
+    config->silencioso = false;
+    config->continuo = false;
+    config->taxa_chegada = 1.0;
+    config->arquivo_trace = NULL;
+    config->total_chegadas = 0;
+    config->duracao_s = 0;
+    config->topologia = NULL;
+    config->peso_contencao = 1.0;
+    config->escala = false;
+    config->tolerancia_escala_ms = 300;
+    config->capacidades[0] = 1;
+    config->num_capacidades = 1;
+    config->processos = 0;
+    config->arquivo_checkpoint = NULL;
+    config->checkpoint_intervalo_ms = 60000;
+    config->arquivo_restauracao = NULL;
+    config->perfil = false;
+    config->soak = false;
+    config->vigia_s = 10;
+    config->giro_max_us = 200;
+    config->semente = (uint64_t)time(NULL);
+    config->comprimento_rota = 0;
+    config->varredura = false;
+    config->num_grade_aeronaves = 0;
+    config->num_grade_setores = 0;
+    config->num_grade_rota = 0;
+    config->num_grade_politicas = 0;
+    config->num_grade_selecoes = 0;
+    config->repeticoes = 1;
+    config->trabalhos = 0;
+
+    // Opções sem forma curta usam códigos acima da faixa de caracteres
+    enum { OPT_TAXA_ENVELHECIMENTO = 256, OPT_PRAZO_MAX_MS, OPT_TAXA_CHEGADA, OPT_TRACE, OPT_CHEGADAS, OPT_DURACAO, OPT_PESO_CONTENCAO, OPT_TOLERANCIA_ESCALA, OPT_PRAZO_SETOR_MS, OPT_PERFIL, OPT_CAPACIDADE, OPT_PROCESSOS,
+           OPT_CHECKPOINT, OPT_CHECKPOINT_INTERVALO, OPT_RESTAURAR, OPT_SOAK, OPT_VIGIA,
+           OPT_SEMENTE, OPT_COMPRIMENTO_ROTA, OPT_VARREDURA, OPT_GRADE_AERONAVES, OPT_GRADE_SETORES, OPT_GRADE_ROTA, OPT_GRADE_POLITICAS,
+           OPT_REPETICOES, OPT_TRABALHOS, OPT_GIRO_MAX,
+           OPT_PESO_PRIORIDADE, OPT_GRADE_SELECOES };
+
+    static const struct option opcoes[] = {
+        {"lookahead", no_argument, NULL, 'l'},
+        {"politica", required_argument, NULL, 'p'},
+        {"selecao", required_argument, NULL, 's'},
+        {"peso-prioridade", required_argument, NULL, OPT_PESO_PRIORIDADE},
+        {"taxa-envelhecimento", required_argument, NULL, OPT_TAXA_ENVELHECIMENTO},
+        {"prazo-max-ms", required_argument, NULL, OPT_PRAZO_MAX_MS},
+        {"prazo-setor-ms", required_argument, NULL, OPT_PRAZO_SETOR_MS},
+        {"silencioso", no_argument, NULL, 'q'},
+        {"continuo", no_argument, NULL, 'c'},
+        {"taxa-chegada", required_argument, NULL, OPT_TAXA_CHEGADA},
+        {"trace", required_argument, NULL, OPT_TRACE},
+        {"chegadas", required_argument, NULL, OPT_CHEGADAS},
+        {"duracao", required_argument, NULL, OPT_DURACAO},
+        {"topologia", required_argument, NULL, 't'},
+        {"peso-contencao", required_argument, NULL, OPT_PESO_CONTENCAO},
+        {"escala", no_argument, NULL, 'e'},
+        {"tolerancia-escala-ms", required_argument, NULL, OPT_TOLERANCIA_ESCALA},
+        {"capacidade", required_argument, NULL, OPT_CAPACIDADE},
+        {"processos", required_argument, NULL, OPT_PROCESSOS},
+        {"checkpoint", required_argument, NULL, OPT_CHECKPOINT},
+        {"checkpoint-intervalo-ms", required_argument, NULL, OPT_CHECKPOINT_INTERVALO},
+        {"restaurar", required_argument, NULL, OPT_RESTAURAR},
+        {"perfil", no_argument, NULL, OPT_PERFIL},
+        {"soak", no_argument, NULL, OPT_SOAK},
+        {"vigia-s", required_argument, NULL, OPT_VIGIA},
+        {"giro-max-us", required_argument, NULL, OPT_GIRO_MAX},
+        {"semente", required_argument, NULL, OPT_SEMENTE},
+        {"comprimento-rota", required_argument, NULL, OPT_COMPRIMENTO_ROTA},
+        {"varredura", no_argument, NULL, OPT_VARREDURA},
+        {"grade-aeronaves", required_argument, NULL, OPT_GRADE_AERONAVES},
+        {"grade-setores", required_argument, NULL, OPT_GRADE_SETORES},
+        {"grade-rota", required_argument, NULL, OPT_GRADE_ROTA},
+        {"grade-politicas", required_argument, NULL, OPT_GRADE_POLITICAS},
+        {"grade-selecoes", required_argument, NULL, OPT_GRADE_SELECOES},
+        {"repeticoes", required_argument, NULL, OPT_REPETICOES},
+        {"trabalhos", required_argument, NULL, OPT_TRABALHOS},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "lp:s:qct:e", opcoes, NULL)) != -1) {
+        switch (opt) {
+            case 'l':
+                config->lookahead = true;
+                break;
+            case 'p':
+                if (!politica_parse(optarg, &config->politica)) {
+                    fprintf(stderr, "ERRO: política desconhecida '%s'.\n", optarg);
+                    config_uso(argv[0]);
+                    return false;
+                }
+                break;
+            case 's':
+                if (!selecao_parse(optarg, &config->selecao)) {
+                    fprintf(stderr, "ERRO: seleção desconhecida '%s'.\n", optarg);
+                    config_uso(argv[0]);
+                    return false;
+                }
+                break;
+            case OPT_PESO_PRIORIDADE:
+                config->peso_prioridade = atof(optarg);
+                break;
+            case OPT_TAXA_ENVELHECIMENTO:
+                if (!parse_limitado("taxa-envelhecimento", optarg, POLITICA_TAXA_MAX, &config->taxa_envelhecimento)) return false;
+                break;
+            case OPT_PRAZO_MAX_MS:
+                if (!parse_limitado("prazo-max-ms", optarg, CONFIG_MAX_MS, &config->prazo_max_ms)) return false;
+                break;
+            case OPT_PRAZO_SETOR_MS:
+                if (!parse_limitado("prazo-setor-ms", optarg, CONFIG_MAX_MS, &config->prazo_setor_ms)) return false;
+                break;
+            case 'q':
+                config->silencioso = true;
+                break;
+            case 'c':
+                config->continuo = true;
+                break;
+            case OPT_TAXA_CHEGADA:
+                config->taxa_chegada = atof(optarg);
+                break;
+            case OPT_TRACE:
+                config->arquivo_trace = optarg;
+                break;
+            case OPT_CHEGADAS:
+                config->total_chegadas = (size_t)atol(optarg);
+                break;
+            case OPT_DURACAO:
+                config->duracao_s = (unsigned int)atoi(optarg);
+                break;
+            case 't':
+                config->topologia = optarg;
+                break;
+            case OPT_PESO_CONTENCAO:
+                config->peso_contencao = atof(optarg);
+                break;
+            case 'e':
+                config->escala = true;
+                break;
+            case OPT_TOLERANCIA_ESCALA:
+                if (!parse_limitado("tolerancia-escala-ms", optarg, CONFIG_MAX_MS, &config->tolerancia_escala_ms)) return false;
+                break;
+            case OPT_CAPACIDADE:
+                if (!parse_capacidades(optarg, config)) {
+                    fprintf(stderr, "ERRO: capacidade inválida '%s' (inteiros positivos separados por vírgula, até %d).\n",
+                            optarg, CONFIG_MAX_CAPACIDADES);
+                    return false;
+                }
+                break;
+            case OPT_PROCESSOS:
+                config->processos = (size_t)atoi(optarg);
+                break;
+            case OPT_CHECKPOINT:
+                config->arquivo_checkpoint = optarg;
+                break;
+            case OPT_CHECKPOINT_INTERVALO:
+                config->checkpoint_intervalo_ms = (unsigned int)atoi(optarg);
+                break;
+            case OPT_RESTAURAR:
+                config->arquivo_restauracao = optarg;
+                break;
+            case OPT_PERFIL:
+                config->perfil = true;
+                break;
+            case OPT_SOAK:
+                config->soak = true;
+                config->silencioso = true;
+                break;
+            case OPT_VIGIA:
+                config->vigia_s = (unsigned int)atoi(optarg);
+                break;
+            case OPT_GIRO_MAX:
+                config->giro_max_us = (unsigned int)atoi(optarg);
+                break;
+            case OPT_SEMENTE:
+                config->semente = (uint64_t)strtoull(optarg, NULL, 10);
+                break;
+            case OPT_COMPRIMENTO_ROTA:
+                config->comprimento_rota = (size_t)atol(optarg);
+                break;
+            case OPT_VARREDURA:
+                config->varredura = true;
+                break;
+            case OPT_GRADE_AERONAVES:
+            case OPT_GRADE_SETORES:
+            case OPT_GRADE_ROTA: {
+                bool ok = opt == OPT_GRADE_AERONAVES ? parse_lista(optarg, config->grade_aeronaves, &config->num_grade_aeronaves, 1)
+                        : opt == OPT_GRADE_SETORES   ? parse_lista(optarg, config->grade_setores, &config->num_grade_setores, 1)
+                                                     : parse_lista(optarg, config->grade_rota, &config->num_grade_rota, 0);
+                if (!ok) {
+                    fprintf(stderr, "ERRO: lista inválida '%s' (inteiros separados por vírgula, até %d).\n", optarg, CONFIG_MAX_GRADE);
+                    return false;
+                }
+                break;
+            }
+            case OPT_GRADE_POLITICAS:
+                if (!parse_politicas(optarg, config)) {
+                    fprintf(stderr, "ERRO: lista de políticas inválida '%s'.\n", optarg);
+                    return false;
+                }
+                break;
+            case OPT_GRADE_SELECOES:
+                if (!parse_selecoes(optarg, config)) {
+                    fprintf(stderr, "ERRO: lista de seleções inválida '%s'.\n", optarg);
+                    return false;
+                }
+                break;
+            case OPT_REPETICOES:
+                config->repeticoes = (size_t)atol(optarg);
+                break;
+            case OPT_TRABALHOS:
+                config->trabalhos = (size_t)atol(optarg);
+                break;
+            default:
+                config_uso(argv[0]);
+                return false;
+        }
+    }
+
+    // Argumentos posicionais (getopt_long os move para o final de argv)
+    bool restaurando = config->arquivo_restauracao != NULL;
+    bool grade_completa = config->varredura && config->num_grade_aeronaves > 0 && config->num_grade_setores > 0;
+    if (argc - optind < 2 && !restaurando && !grade_completa) {
+        config_uso(argv[0]);
+        return false;
+    }
+
+    if (argc - optind >= 2) {
+        config->num_aeronaves = (size_t)atoi(argv[optind]);
+        config->num_setores = (size_t)atoi(argv[optind + 1]);
+    }
+
+    // Eixos omitidos da varredura ficam com o valor único da execução simples
+    if (config->varredura) {
+        if (config->num_grade_aeronaves == 0) {
+            config->grade_aeronaves[config->num_grade_aeronaves++] = config->num_aeronaves;
+        }
+        if (config->num_grade_setores == 0) {
+            config->grade_setores[config->num_grade_setores++] = config->num_setores;
+        }
+        if (config->num_grade_rota == 0) {
+            config->grade_rota[config->num_grade_rota++] = config->comprimento_rota;
+        }
+        if (config->num_grade_politicas == 0) {
+            config->grade_politicas[config->num_grade_politicas++] = config->politica;
+        }
+        if (config->num_grade_selecoes == 0) {
+            config->grade_selecoes[config->num_grade_selecoes++] = config->selecao;
+        }
+        config->num_aeronaves = config->grade_aeronaves[0];
+        config->num_setores = config->grade_setores[0];
+        if (config->trabalhos == 0) {
+            long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+            config->trabalhos = processadores > 0 ? (size_t)processadores : 1;
+        }
+    }
+
+    if (!restaurando && (config->num_aeronaves == 0 || config->num_setores == 0)) {
+        fprintf(stderr, "ERRO: número de aeronaves e de setores devem ser maiores que zero.\n");
+        return false;
+    }
+
+    if (config->peso_prioridade < 0.0 || config->peso_prioridade > 1.0) {
+        fprintf(stderr, "ERRO: o peso da prioridade deve estar entre 0 e 1.\n");
+        return false;
+    }
+
+    // A escala é compilada para a frota fixa do modo em lote, com a ocupação de um setor por vez
+    if (config->escala && (config->continuo || config->lookahead)) {
+        fprintf(stderr, "ERRO: a escala não pode ser combinada com o modo contínuo nem com o lookahead.\n");
+        return false;
+    }
+    // Os bilhetes são indexados pela rota compilada, que o reencaminhamento alteraria
+    if (config->escala && config->prazo_setor_ms > 0) {
+        fprintf(stderr, "ERRO: a escala não pode ser combinada com prazo por setor.\n");
+        return false;
+    }
+
+    // Os processos de trabalho recebem a frota fixa já planejada; a escala, o reencaminhamento e o
+    // perfil guardam estado fora do segmento compartilhado
+    if (config->processos > 0 && (config->continuo || config->escala || config->prazo_setor_ms > 0 || config->perfil)) {
+        fprintf(stderr, "ERRO: --processos não pode ser combinado com o modo contínuo, a escala, o prazo por setor nem o perfil.\n");
+        return false;
+    }
+
+    // O instantâneo cobre a frota fixa do modo em lote com solicitações simples: reservas do
+    // lookahead, bilhetes da escala e cancelamentos estariam em trânsito no ponto de parada
+    bool checkpoint = config->arquivo_checkpoint != NULL || restaurando;
+    if (checkpoint && (config->continuo || config->escala || config->lookahead || config->prazo_setor_ms > 0 || config->processos > 0)) {
+        fprintf(stderr, "ERRO: checkpoint/restauração não podem ser combinados com o modo contínuo, a escala, o lookahead, o prazo por setor nem --processos.\n");
+        return false;
+    }
+    if (restaurando && config->topologia != NULL) {
+        fprintf(stderr, "ERRO: na restauração as rotas vêm do checkpoint; não informe --topologia.\n");
+        return false;
+    }
+    if (config->arquivo_checkpoint != NULL && config->checkpoint_intervalo_ms == 0) {
+        fprintf(stderr, "ERRO: o intervalo entre checkpoints deve ser maior que zero.\n");
+        return false;
+    }
+
+    // A escala é planejada com a permanência real nos setores; o vigia e as varreduras leem o estado
+    // do processo principal e não encerram processos de trabalho presos
+    if (config->soak && (config->escala || config->processos > 0)) {
+        fprintf(stderr, "ERRO: --soak não pode ser combinado com a escala nem com --processos.\n");
+        return false;
+    }
+
+    // A varredura executa instâncias em lote independentes e silenciosas no mesmo processo: o perfil,
+    // o segmento compartilhado e o arquivo de checkpoint são únicos por processo, e o vigia do soak
+    // encerra o processo inteiro no impasse (levaria junto as demais execuções e o CSV agregado)
+    if (config->varredura) {
+        if (config->continuo || config->processos > 0 || config->perfil || checkpoint || config->soak) {
+            fprintf(stderr, "ERRO: --varredura não pode ser combinada com o modo contínuo, --processos, o perfil, checkpoint/restauração nem --soak.\n");
+            return false;
+        }
+        if (config->repeticoes == 0) {
+            fprintf(stderr, "ERRO: o número de repetições deve ser maior que zero.\n");
+            return false;
+        }
+        config->silencioso = true;
+    }
+
+    if (config->continuo && config->arquivo_trace == NULL) {
+        if (config->taxa_chegada <= 0.0) {
+            fprintf(stderr, "ERRO: a taxa de chegada deve ser maior que zero.\n");
+            return false;
+        }
+        if (config->total_chegadas == 0 && config->duracao_s == 0) {
+            fprintf(stderr, "ERRO: o modo contínuo com chegadas de Poisson exige --chegadas ou --duracao.\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned int config_capacidade(const config_t* config, size_t setor) {
+    if (config->num_capacidades == 0) return 1;
+    return config->capacidades[setor % config->num_capacidades];
+}
+
+size_t config_comprimento_rota(const config_t* config, size_t num_setores, aleatorio_t* aleatorio) {
+    if (config->comprimento_rota == 0) return aleatorio_intervalo(aleatorio, num_setores) + 1;
+    return config->comprimento_rota < num_setores ? config->comprimento_rota : num_setores;
+}
@@ -0,0 +1,156 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "politica.h"
+#include "utils.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Número máximo de valores distintos em --capacidade (a lista é repetida ciclicamente pelos setores)
+#define CONFIG_MAX_CAPACIDADES 64
+
+// Número máximo de valores em cada eixo da grade da varredura
+#define CONFIG_MAX_GRADE 32
+
+// Maior valor aceito nas opções de prazo e tolerância em ms (24 h)
+#define CONFIG_MAX_MS 86400000L
+
+/**
+ * @brief Parâmetros de uma execução da simulação
+ * 
+ * @param num_aeronaves Número de aeronaves da frota
+ * @param num_setores Número de setores do espaço aéreo
+ * @param lookahead Reserva o próximo setor da rota enquanto a aeronave ainda voa no atual
+ * @param politica Política de ordenação das filas dos setores
+ * @param selecao Escolha entre as aeronaves seguras da fila quando o setor tem vaga
+ * @param peso_prioridade Peso da prioridade estática (0 a 1) na seleção mista
+ * @param taxa_envelhecimento Pontos de prioridade ganhos por segundo de espera (política envelhecimento)
+ * @param prazo_max_ms Prazo da aeronave de menor prioridade (política prazo)
+ * @param silencioso Desabilita o log de eventos (printf_timestamped)
+ * @param continuo Operação contínua: aeronaves chegam e se aposentam; num_aeronaves passa a ser o número de slots
+ * @param taxa_chegada Taxa média de chegadas por segundo (processo de Poisson)
+ * @param arquivo_trace Arquivo com os instantes de chegada em ms (um por linha); substitui a taxa
+ * @param total_chegadas Encerra após este número de chegadas (0 = sem limite)
+ * @param duracao_s Encerra as chegadas após este tempo em segundos (0 = sem limite)
+ * @param topologia "grade" ou caminho de um arquivo de arestas; NULL usa rotas aleatórias sem adjacência
+ * @param peso_contencao Peso da contenção prevista no custo do planejador de rotas
+ * @param prazo_setor_ms Prazo de cada espera por setor; ao expirar a aeronave é reencaminhada (0 = sem prazo)
+ * @param escala Compila uma escala de entradas antes das threads e a segue (modo em lote)
+ * @param tolerancia_escala_ms Atraso admitido de um bilhete antes do retorno ao controle online
+ * @param capacidades Aeronaves simultâneas admitidas por setor (lista repetida ciclicamente)
+ * @param num_capacidades Número de valores em capacidades
+ * @param processos Processos de trabalho das aeronaves, com o estado em memória compartilhada (0 = threads no próprio processo)
+ * @param arquivo_checkpoint Grava periodicamente um instantâneo da simulação neste arquivo (NULL = desabilitado)
+ * @param checkpoint_intervalo_ms Intervalo entre checkpoints
+ * @param arquivo_restauracao Retoma a simulação a partir deste instantâneo (dimensões e rotas vêm dele)
+ * @param perfil Instrumenta os locks e as fases do controlador e imprime o perfil ao final
+ * @param soak Permanência ~0 nos setores e verificação online das invariantes (implica silencioso)
+ * @param vigia_s Prazo sem concessões, com aeronaves nas filas, que o vigia do soak declara impasse (0 = sem vigia)
+ * @param giro_max_us Janela máxima de giro antes de bloquear à espera da concessão (0 = bloqueia direto)
+ * @param semente Semente do gerador da simulação (a mesma semente reproduz frota, rotas e chegadas)
+ * @param comprimento_rota Setores de cada rota aleatória, limitado ao número de setores (0 = sorteado entre 1 e num_setores)
+ * @param varredura Executa a grade de configurações abaixo em simulações paralelas no mesmo processo
+ * @param grade_aeronaves Valores de num_aeronaves da varredura
+ * @param grade_setores Valores de num_setores da varredura
+ * @param grade_rota Valores de comprimento_rota da varredura
+ * @param grade_politicas Políticas das filas da varredura
+ * @param grade_selecoes Seleções de concessão da varredura
+ * @param repeticoes Execuções de cada ponto da grade (sementes consecutivas)
+ * @param trabalhos Simulações executadas ao mesmo tempo na varredura
+ */
+typedef struct config {
+    size_t num_aeronaves;
+    size_t num_setores;
+    bool lookahead;
+    politica_tipo_t politica;
+    selecao_tipo_t selecao;
+    double peso_prioridade;
+    unsigned int taxa_envelhecimento;
+    unsigned int prazo_max_ms;
+    unsigned int prazo_setor_ms;
+    bool silencioso;
+
+    bool continuo;
+    double taxa_chegada;
+    const char* arquivo_trace;
+    size_t total_chegadas;
+    unsigned int duracao_s;
+
+    const char* topologia;
+    double peso_contencao;
+
+    bool escala;
+    unsigned int tolerancia_escala_ms;
+
+    unsigned int capacidades[CONFIG_MAX_CAPACIDADES];
+    size_t num_capacidades;
+
+    size_t processos;
+
+    const char* arquivo_checkpoint;
+    unsigned int checkpoint_intervalo_ms;
+    const char* arquivo_restauracao;
+
+    bool perfil;
+
+    bool soak;
+    unsigned int vigia_s;
+
+    unsigned int giro_max_us;
+
+    uint64_t semente;
+    size_t comprimento_rota;
+
+    bool varredura;
+    size_t grade_aeronaves[CONFIG_MAX_GRADE];
+    size_t num_grade_aeronaves;
+    size_t grade_setores[CONFIG_MAX_GRADE];
+    size_t num_grade_setores;
+    size_t grade_rota[CONFIG_MAX_GRADE];
+    size_t num_grade_rota;
+    politica_tipo_t grade_politicas[CONFIG_MAX_GRADE];
+    size_t num_grade_politicas;
+    selecao_tipo_t grade_selecoes[CONFIG_MAX_GRADE];
+    size_t num_grade_selecoes;
+    size_t repeticoes;
+    size_t trabalhos;
+} config_t;
+
+/**
+ * @brief Lê os parâmetros da linha de comando
+ * 
+ * Formato: <num_aeronaves> <num_setores> [opções]
+ * Com --restaurar os argumentos posicionais são opcionais (as dimensões vêm do instantâneo); na
+ * varredura eles são o valor dos eixos da grade que não forem informados.
+ * No modo contínuo, <num_aeronaves> é o número máximo de aeronaves simultâneas (slots).
+ * 
+ * @param config struct a ser preenchida
+ * @param argc 
+ * @param argv 
+ * @return true se os parâmetros são válidos
+ * @return false caso contrário (a mensagem de uso já foi impressa)
+ */
+bool config_parse(config_t* config, int argc, char** argv);
+
+/**
+ * @brief Capacidade de um setor: o valor da lista --capacidade na posição setor (módulo o tamanho)
+ * 
+ * @param config parâmetros lidos por config_parse
+ * @param setor índice do setor
+ * @return unsigned int aeronaves simultâneas admitidas (1 se nenhuma capacidade foi informada)
+ */
+unsigned int config_capacidade(const config_t* config, size_t setor);
+
+/**
+ * @brief Comprimento da próxima rota aleatória: comprimento_rota (limitado aos setores) ou sorteado
+ * 
+ * @param config parâmetros lidos por config_parse
+ * @param num_setores setores disponíveis
+ * @param aleatorio gerador de quem monta a rota
+ * @return size_t entre 1 e num_setores
+ */
+size_t config_comprimento_rota(const config_t* config, size_t num_setores, aleatorio_t* aleatorio);
+
+#endif
@@ -0,0 +1,173 @@
+#define _POSIX_C_SOURCE 200112L // importante para clock_nanosleep em time.h
+#include "continuo.h"
+#include "rota.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#define NS_POR_MS 1000000LL
+#define NS_POR_S  1000000000LL
+
+// Dorme até o instante absoluto (CLOCK_MONOTONIC) em ns
+static void dormir_ate(long long instante_ns) {
+    struct timespec ts;
+    ts.tv_sec = instante_ns / NS_POR_S;
+    ts.tv_nsec = instante_ns % NS_POR_S;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        // EINTR: volta a dormir
+    }
+}
+
+// Intervalo exponencial entre chegadas de um processo de Poisson com a taxa dada (por segundo)
+static long long intervalo_poisson_ns(double taxa, aleatorio_t* aleatorio) {
+    // u em (0, 1): evita log(0)
+    double u = aleatorio_uniforme(aleatorio);
+    return (long long)(-log(u) / taxa * (double)NS_POR_S);
+}
+
+// Obtém o próximo instante de chegada relativo ao início. Retorna false quando não há mais chegadas.
+static bool proxima_chegada(const config_t* config, FILE* trace, aleatorio_t* aleatorio, long long* instante_ns) {
+    if (trace != NULL) {
+        double ms;
+        if (fscanf(trace, "%lf", &ms) != 1) return false;
+        *instante_ns = (long long)(ms * (double)NS_POR_MS);
+    } else {
+        *instante_ns += intervalo_poisson_ns(config->taxa_chegada, aleatorio);
+    }
+
+    if (config->duracao_s > 0 && *instante_ns >= (long long)config->duracao_s * NS_POR_S) return false;
+
+    return true;
+}
+
+// Prepara o slot para a nova aeronave e avisa o banqueiro da sua demanda
+static void admitir_aeronave(const config_t* config, controle_t* ctrl, setor_t* setores, size_t num_setores, aeronave_t* aero, size_t numero, long long chegada_ns) {
+    // O id e a rota do ocupante anterior já foram descartados pelo banqueiro na aposentadoria
+    free(aero->id);
+    aero->id = create_id('A', (int)numero);
+    aero->prioridade = (unsigned int)aleatorio_intervalo(&ctrl->aleatorio, 1001);
+    if (ctrl->planejador != NULL) {
+        aero->rota = criar_rota_planejada(ctrl->planejador, setores, num_setores, &ctrl->aleatorio);
+    } else {
+        aero->rota = criar_rota(setores, num_setores, config_comprimento_rota(config, num_setores, &ctrl->aleatorio), &ctrl->aleatorio);
+    }
+    aero->chegada_ns = chegada_ns;
+
+    aeronave_estado_t* estado = aero->estado;
+    pthread_mutex_lock(&estado->lock);
+    estado->espera_total_ns = 0;
+    estado->espera_max_ns = 0;
+    estado->current_setor = -1;
+    estado->setor_concedido = -1;
+    atomic_store_explicit(&estado->concessao_sinal, -1, memory_order_relaxed);
+    estado->finished = false;
+    estado->cancelamento_confirmado = false;
+    estado->timeouts = 0;
+    estado->retomar_aguardando = false;
+    pthread_mutex_unlock(&estado->lock);
+
+    printf_timestamped("[CHEGADAS] Aeronave %s chegou (slot %d, rota com %zu setores).\n", aero->id, aero->aero_index, aero->rota.len);
+
+    // A primeira solicitação da aeronave é enviada depois desta mensagem, então
+    // o banqueiro sempre conhece a demanda antes do primeiro pedido
+    mensagem_t* msg = &estado->msg_controle;
+    caixa_postal_reservar(msg);
+    msg->tipo = MSG_ADMISSAO;
+    msg->aero_index = aero->aero_index;
+    msg->setor_index = -1;
+    caixa_postal_enviar(&ctrl->caixa, msg);
+}
+
+int executar_continuo(const config_t* config, controle_t* ctrl, setor_t* setores, size_t num_setores, aeronave_t* aeronaves, resultado_continuo_t* resultado) {
+    resultado->chegadas = 0;
+    resultado->duracao_ns = 0;
+    histograma_init(&resultado->atraso_admissao);
+
+    FILE* trace = NULL;
+    if (config->arquivo_trace != NULL) {
+        trace = fopen(config->arquivo_trace, "r");
+        if (trace == NULL) {
+            perror("Falha ao abrir o arquivo de trace");
+            return -1;
+        }
+    }
+
+    // As threads das aeronaves não são unidas: o fim de cada uma é sinalizado pela aposentadoria
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    int erro = 0;
+    long long inicio_ns = tempo_monotonico_ns();
+    long long instante_ns = 0;
+
+    while (config->total_chegadas == 0 || resultado->chegadas < config->total_chegadas) {
+        if (!proxima_chegada(config, trace, &ctrl->aleatorio, &instante_ns)) break;
+
+        dormir_ate(inicio_ns + instante_ns);
+        long long chegada_ns = tempo_monotonico_ns();
+
+        // Bloqueia se todos os slots estiverem ocupados (memória limitada pelas aeronaves simultâneas)
+        int slot = controle_reservar_slot(ctrl);
+        histograma_registrar(&resultado->atraso_admissao, tempo_monotonico_ns() - chegada_ns);
+
+        aeronave_t* aero = &aeronaves[slot];
+        admitir_aeronave(config, ctrl, setores, num_setores, aero, resultado->chegadas, chegada_ns);
+        resultado->chegadas++;
+
+        pthread_t thread;
+        int res = pthread_create(&thread, &attr, aeronave_thread_continuo, (void *)aero);
+        if (res != 0) {
+            fprintf(stderr, "Erro ao criar thread: %d\n", res);
+
+            // A aeronave nunca voou: aposenta o slot diretamente. msg_controle ainda pode
+            // estar pendente (admissão), então usamos a mensagem de liberação, que está livre.
+            mensagem_t* msg = &aero->estado->msg_liberacao;
+            caixa_postal_reservar(msg);
+            msg->tipo = MSG_APOSENTADORIA;
+            msg->aero_index = slot;
+            msg->setor_index = -1;
+            caixa_postal_enviar(&ctrl->caixa, msg);
+
+            erro = -1;
+            break;
+        }
+    }
+
+    pthread_attr_destroy(&attr);
+    if (trace != NULL) fclose(trace);
+
+    // Espera todas as aeronaves em voo se aposentarem
+    controle_aguardar_slots_livres(ctrl);
+    resultado->duracao_ns = tempo_monotonico_ns() - inicio_ns;
+
+    return erro;
+}
+
+void imprimir_resultado_continuo(const resultado_continuo_t* resultado, const estatisticas_operacao_t* estatisticas) {
+    double duracao_s = (double)resultado->duracao_ns / (double)NS_POR_S;
+    double ms = (double)NS_POR_MS;
+
+    printf("\n=== RESULTADOS DA OPERAÇÃO CONTÍNUA ===\n");
+    printf("Chegadas: %zu | Aposentadas: %zu | Duração: %.2f s\n", resultado->chegadas, estatisticas->aposentadas, duracao_s);
+    printf("Vazão: %.3f aeronaves/s | %.3f setores/s\n", 
+           duracao_s > 0 ? (double)estatisticas->aposentadas / duracao_s : 0.0,
+           duracao_s > 0 ? (double)estatisticas->saltos / duracao_s : 0.0);
+    printf("Espera média por setor: %.2f ms\n", 
+           estatisticas->saltos > 0 ? (double)estatisticas->espera_total_ns / (double)estatisticas->saltos / ms : 0.0);
+    printf("Espera média por aeronave: p50 %.2f ms | p99 %.2f ms | máx %.2f ms\n",
+           (double)histograma_percentil(&estatisticas->espera_media, 50) / ms,
+           (double)histograma_percentil(&estatisticas->espera_media, 99) / ms,
+           (double)estatisticas->espera_media.max / ms);
+    printf("Tempo no sistema: média %.2f ms | p50 %.2f ms | p99 %.2f ms\n",
+           histograma_media(&estatisticas->tempo_sistema) / ms,
+           (double)histograma_percentil(&estatisticas->tempo_sistema, 50) / ms,
+           (double)histograma_percentil(&estatisticas->tempo_sistema, 99) / ms);
+    printf("Atraso de admissão (slot livre): média %.2f ms | p99 %.2f ms\n",
+           histograma_media(&resultado->atraso_admissao) / ms,
+           (double)histograma_percentil(&resultado->atraso_admissao, 99) / ms);
+}
@@ -0,0 +1,54 @@
+#ifndef CONTINUO_H
+#define CONTINUO_H
+
+#include "config.h"
+#include "controle.h"
+#include "setor.h"
+#include "aeronave.h"
+#include "utils.h"
+
+/**
+ * @brief Resultado do gerador de chegadas da operação contínua
+ * 
+ * As estatísticas por aeronave (espera, tempo no sistema) são acumuladas pelo
+ * banqueiro em controle_t.estatisticas a cada aposentadoria.
+ * 
+ * @param chegadas número de aeronaves que chegaram
+ * @param duracao_ns tempo entre o início das chegadas e a última aposentadoria
+ * @param atraso_admissao distribuição da espera por um slot livre na chegada (ns)
+ */
+typedef struct resultado_continuo {
+    size_t chegadas;
+    long long duracao_ns;
+    histograma_t atraso_admissao;
+} resultado_continuo_t;
+
+/**
+ * @brief Executa a operação contínua (open-loop)
+ * 
+ * Gera as chegadas (Poisson com config->taxa_chegada ou instantes lidos de
+ * config->arquivo_trace), admite cada aeronave em um slot livre com uma nova rota e
+ * cria sua thread. Se todos os slots estiverem ocupados, a chegada espera por um slot
+ * (contabilizado como atraso de admissão). Retorna depois que todas as aeronaves se aposentaram.
+ * 
+ * A thread do banqueiro já deve estar em execução.
+ * 
+ * @param config parâmetros da execução
+ * @param ctrl controle global (dimensionado pelo número de slots)
+ * @param setores vetor de setores
+ * @param num_setores tamanho do vetor de setores
+ * @param aeronaves vetor de slots de aeronaves (inicializado com init_aeronaves)
+ * @param resultado saída com as estatísticas do gerador
+ * @return int 0 em sucesso, -1 em caso de erro
+ */
+int executar_continuo(const config_t* config, controle_t* ctrl, setor_t* setores, size_t num_setores, aeronave_t* aeronaves, resultado_continuo_t* resultado);
+
+/**
+ * @brief Imprime o resumo da operação contínua (vazão, esperas e tempo no sistema)
+ * 
+ * @param resultado resultado do gerador de chegadas
+ * @param estatisticas estatísticas acumuladas pelo banqueiro
+ */
+void imprimir_resultado_continuo(const resultado_continuo_t* resultado, const estatisticas_operacao_t* estatisticas);
+
+#endif
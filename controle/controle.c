@@ -1,218 +1,832 @@
-#include <errno.h> // para ETIMEDOUT
 #include <string.h>
 #include "controle.h"
 #include "aeronave.h"
+#include "rota.h"
 #include "utils.h"
+#include "perfil.h"
+#include "memoria.h"
+#include "checkpoint.h"
+#include "invariantes.h"
 
-void init_controle(controle_t* controle, size_t num_aeronaves, size_t num_setores) {
+void init_controle(controle_t* controle, size_t num_aeronaves, size_t num_setores, const config_t* config) {
     if (num_aeronaves == 0 || num_setores == 0) return;
 
     controle->num_aeronaves = num_aeronaves;
     controle->num_setores = num_setores;
+    controle->lookahead = config->lookahead;
+    controle->prazo_setor_ms = config->prazo_setor_ms;
+    controle->giro_max_ns = (long long)config->giro_max_us * 1000LL;
+    controle->sem_permanencia = config->soak;
+    controle->invariantes = NULL;
+    aleatorio_semear(&controle->aleatorio, config->semente);
+
+    controle->arquivo_checkpoint = config->arquivo_checkpoint;
+    controle->checkpoint_intervalo_ns = (long long)config->checkpoint_intervalo_ms * 1000000LL;
+    controle->proximo_checkpoint_ns = tempo_monotonico_ns() + controle->checkpoint_intervalo_ns;
+    controle->estacionadas = 0;
+    controle->checkpoints = 0;
+    controle->pausa_total_ns = 0;
+    controle->gravacao_total_ns = 0;
+
+    controle->politica.tipo = config->politica;
+    controle->politica.taxa_envelhecimento = config->taxa_envelhecimento;
+    controle->politica.prazo_max_ms = config->prazo_max_ms;
+    controle->politica.t_inicio_ns = tempo_monotonico_ns();
+
+    controle->selecao = config->selecao;
+    controle->peso_prioridade = config->peso_prioridade;
+    controle->candidatos = NULL;
+    controle->candidatos_cap = 0;
+    controle->candidatos_usados = 0;
+    if (config->selecao != SELECAO_FILA) {
+        // Uma decisão cabe sempre; folga para as aninhadas dos repasses em cascata
+        controle->candidatos_cap = 2 * num_aeronaves;
+        controle->candidatos = (candidato_t *)memoria_alocar(controle->candidatos_cap, sizeof(candidato_t));
+        if (!controle->candidatos) return;
+    }
+
+    // Nós das filas dos setores: cada aeronave está em no máximo uma fila por vez
+    controle->fila_nos = (fila_no_t *)memoria_alocar(num_aeronaves, sizeof(fila_no_t));
+    if (!controle->fila_nos) return;
+    for (size_t i = 0; i < num_aeronaves; i++) {
+        controle->fila_nos[i].prox = -1;
+        controle->fila_nos[i].ant = -1;
+        controle->fila_nos[i].setor_index = -1;
+    }
 
-    // Alocação dos vetores (Available e Finish)
-    controle->available = (int *)calloc(num_setores, sizeof(int));
-    if (!controle->available) return;
-    
-    // Inicializa todos os recursos como disponíveis (1 instância por setor)
+    // Estado do banqueiro: matrizes zeradas e a capacidade de cada setor disponível
+    void* bloco_banqueiro = memoria_alocar(1, banqueiro_tamanho(num_aeronaves, num_setores));
+    controle->capacidade = (int *)memoria_alocar(num_setores, sizeof(int));
+    if (!bloco_banqueiro || !controle->capacidade) return;
+    controle->banqueiro = banqueiro_iniciar_em(bloco_banqueiro, num_aeronaves, num_setores);
     for (size_t j = 0; j < num_setores; j++) {
-        controle->available[j] = 1; 
+        controle->capacidade[j] = (int)config_capacidade(config, j);
+        banqueiro_definir_disponivel(controle->banqueiro, (int)j, controle->capacidade[j]);
     }
 
-    // Alocação das matrizes (Max, Allocation, Need)
-    // Alocação das linhas (num_aero) e, em seguida, das colunas (num_set)
-    controle->max        = (int **)calloc(num_aeronaves, sizeof(int *));
-    controle->allocation = (int **)calloc(num_aeronaves, sizeof(int *));
-    controle->need       = (int **)calloc(num_aeronaves, sizeof(int *));
+    if (!componentes_init(&controle->componentes, num_aeronaves, num_setores)) return;
+    controle->componentes_desatualizadas = true;
+    controle->componentes_demanda_nova = true;
+    controle->aeronave_ativa = (bool *)memoria_alocar(num_aeronaves, sizeof(bool));
+    if (!controle->aeronave_ativa) return;
 
-    if (!controle->max || !controle->allocation || !controle->need) return;
+    controle->setor_ocupado = (int *)memoria_alocar(num_aeronaves, sizeof(int));
+    controle->rascunho = (int *)memoria_alocar(3 * num_setores, sizeof(int));
+    if (!controle->setor_ocupado || !controle->rascunho) return;
     for (size_t i = 0; i < num_aeronaves; i++) {
-        controle->max[i]        = (int *)calloc(num_setores, sizeof(int));
-        controle->allocation[i] = (int *)calloc(num_setores, sizeof(int));
-        controle->need[i]       = (int *)calloc(num_setores, sizeof(int));
-        
-        if (!controle->max[i] || !controle->allocation[i] || !controle->need[i]) return;
+        controle->setor_ocupado[i] = -1;
     }
 
-    // Inicializa o Mutex e Condição
-    pthread_mutex_init(&controle->banker_lock, NULL);
-    pthread_cond_init(&controle->new_request_cond, NULL);
+    // Todos os slots começam livres (usado apenas na operação contínua)
+    controle->slots_livres = (int *)memoria_alocar(num_aeronaves, sizeof(int));
+    if (!controle->slots_livres) return;
+    for (size_t i = 0; i < num_aeronaves; i++) {
+        // Empilhados em ordem inversa para que o slot 0 seja o primeiro a sair
+        controle->slots_livres[i] = (int)(num_aeronaves - 1 - i);
+    }
+    controle->num_slots_livres = num_aeronaves;
+
+    controle->planejador = NULL;
+    controle->escala = NULL;
+
+    memset(&controle->estatisticas, 0, sizeof(controle->estatisticas));
+    histograma_init(&controle->estatisticas.espera_media);
+    histograma_init(&controle->estatisticas.tempo_sistema);
+
+    // Inicializa os Mutexes, a condição e a caixa postal (process-shared com memória compartilhada)
+    memoria_mutex_init(&controle->banker_lock);
+    memoria_mutex_init(&controle->slots_lock);
+    memoria_cond_init(&controle->slots_cond, false);
+    memoria_mutex_init(&controle->pausa_lock);
+    memoria_cond_init(&controle->pausa_cond, false);
+    caixa_postal_init(&controle->caixa);
+    atomic_init(&controle->encerrar, false);
+    atomic_init(&controle->pausa, false);
 }
 
 void destroy_controle(controle_t* controle) {
     if (controle == NULL) return;
 
-    // Liberação das matrizes
-    for (size_t i = 0; i < controle->num_aeronaves; i++) {
-        free(controle->max[i]);
-        free(controle->allocation[i]);
-        free(controle->need[i]);
-    }
-    free(controle->max);
-    free(controle->allocation);
-    free(controle->need);
+    // Liberação do estado do banqueiro
+    memoria_liberar(controle->banqueiro);
+    memoria_liberar(controle->capacidade);
+    componentes_destroy(&controle->componentes);
+    memoria_liberar(controle->aeronave_ativa);
 
     // Liberação dos vetores
-    free(controle->available);
+    memoria_liberar(controle->fila_nos);
+    memoria_liberar(controle->setor_ocupado);
+    memoria_liberar(controle->rascunho);
+    memoria_liberar(controle->slots_livres);
+    memoria_liberar(controle->candidatos);
 
-    // Destruição do Mutex
+    // Destruição dos Mutexes, da condição e da caixa postal
     pthread_mutex_destroy(&controle->banker_lock);
-    pthread_cond_destroy(&controle->new_request_cond);
+    pthread_mutex_destroy(&controle->slots_lock);
+    pthread_mutex_destroy(&controle->pausa_lock);
+    pthread_cond_destroy(&controle->pausa_cond);
+    pthread_cond_destroy(&controle->slots_cond);
+    caixa_postal_destroy(&controle->caixa);
 }
 
-void* banqueiro_thread(void* arg) {
-    controle_t* ctrl = (controle_t*)arg;
+// Notifica a aeronave (e somente ela) de que o setor foi concedido
+static void notificar_concessao(controle_t* ctrl, int aero_idx, int setor_idx) {
+    aeronave_estado_t* estado = &ctrl->estados[aero_idx];
 
-    // Loop para monitorar as solicitações
-    while (existe_aerothread_alive(ctrl)) {
+    long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
+    if (ctrl->invariantes != NULL && estado->setor_concedido != -1) {
+        invariantes_violacao(ctrl->invariantes, "concessão do setor %d sobrescreve a do setor %d ainda pendente (aeronave %s)",
+                             setor_idx, estado->setor_concedido, ctrl->aeronaves[aero_idx].id);
+    }
+    estado->setor_concedido = setor_idx;
+    atomic_store_explicit(&estado->concessao_sinal, setor_idx, memory_order_release);
+    pthread_cond_signal(&estado->concessao_cond);
+    perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+}
 
-        printf_timestamped("[BANQUEIRO] Aguardando novas solicitações...\n");
-        pthread_mutex_lock(&ctrl->banker_lock);
+// Devolve um slot para a pilha de livres e acorda o gerador de chegadas
+static void devolver_slot(controle_t* ctrl, int aero_idx) {
+    long long adquirido_ns = perfil_lock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS);
+    ctrl->slots_livres[ctrl->num_slots_livres++] = aero_idx;
+    pthread_cond_broadcast(&ctrl->slots_cond);
+    perfil_unlock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS, adquirido_ns);
+}
 
-        struct timespec ts = get_abs_timeout(5);
-        int wait_res = pthread_cond_timedwait(&ctrl->new_request_cond, &ctrl->banker_lock, &ts);
-        if (wait_res == ETIMEDOUT) {
-            printf_timestamped("[BANQUEIRO] Timeout de espera atingido. Verificando novamente...\n");
+// Remove do planejador a demanda dos setores de `desde` em diante, em blocos de até num_setores
+// (um desvio pode deixar a rota com mais saltos que setores)
+static void remover_demanda_trecho(controle_t* ctrl, const rota_node_t* desde, int* bloco) {
+    size_t len = 0;
+    for (const rota_node_t* curr = desde; curr != NULL; curr = curr->next) {
+        bloco[len++] = curr->setor->setor_index;
+        if (len == ctrl->num_setores) {
+            planejador_remover_rota(ctrl->planejador, bloco, len);
+            len = 0;
         }
+    }
+    if (len > 0) {
+        planejador_remover_rota(ctrl->planejador, bloco, len);
+    }
+}
 
-        printf_timestamped("[BANQUEIRO] Acordado para processar solicitações.\n");
-        for (size_t i = 0; i < ctrl->num_setores; i++) {
-            setor_t* setor = &ctrl->setores[i];
-            pthread_mutex_lock(&setor->lock);
-            if (setor->fila_len > 0) {
-                bool setor_concedido = false;
-
-                for (size_t fila_i = 0; fila_i < setor->fila_len && !setor_concedido; fila_i++) {
-                    aeronave_t* aeronave = &setor->fila[fila_i];
-                    int setor_origem_idx = aeronave->current_setor ? aeronave->current_setor->setor_index : -1;
-                    if ((setor_concedido = setor_tenta_conceder_seguro(ctrl, aeronave->aero_index, setor->setor_index, setor_origem_idx))) {
-                        printf_timestamped("[BANQUEIRO] Concedeu setor %s para aeronave %s.\n", setor->id, aeronave->id);
-                        pthread_cond_broadcast(&setor->setor_disponivel_cond);
-                    } 
-                }
-            }
+// Encerra a participação de uma aeronave: libera o último setor, contabiliza
+// as estatísticas, zera a linha do banqueiro e recicla o slot
+static void aposentar_aeronave(controle_t* ctrl, int aero_idx, int setor_final_idx) {
+    aeronave_t* aero = &ctrl->aeronaves[aero_idx];
+    aeronave_estado_t* estado = &ctrl->estados[aero_idx];
 
-            pthread_mutex_unlock(&setor->lock);
+    printf_timestamped("[BANQUEIRO] Aeronave %s aposentada.\n", aero->id);
+
+    if (setor_final_idx != -1) {
+        liberar_recurso_banqueiro(ctrl, aero_idx, setor_final_idx);
+    }
+
+    // Zera a demanda da linha (somente as colunas da rota podem ser não nulas)
+    for (rota_node_t* curr = aero->rota.head; curr != NULL; curr = curr->next) {
+        int j = curr->setor->setor_index;
+        liberar_recurso_banqueiro(ctrl, aero_idx, j);
+        banqueiro_definir_max(ctrl->banqueiro, aero_idx, j, 0);
+    }
+    ctrl->setor_ocupado[aero_idx] = -1;
+    ctrl->aeronave_ativa[aero_idx] = false;
+    ctrl->componentes_desatualizadas = true;
+
+    long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
+    long long espera_ns = estado->espera_total_ns;
+    perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+
+    estatisticas_operacao_t* est = &ctrl->estatisticas;
+    est->aposentadas++;
+    est->saltos += aero->rota.len;
+    est->espera_total_ns += espera_ns;
+    if (aero->rota.len > 0) {
+        histograma_registrar(&est->espera_media, espera_ns / (long long)aero->rota.len);
+    }
+    histograma_registrar(&est->tempo_sistema, tempo_monotonico_ns() - aero->chegada_ns);
+
+    // A rota deixa de contar como demanda para o planejamento das próximas chegadas
+    if (ctrl->planejador != NULL) {
+        remover_demanda_trecho(ctrl, aero->rota.head, ctrl->rascunho);
+    }
+
+    // Dados frios do slot são descartados; a próxima aeronave os recria
+    free(aero->id);
+    aero->id = NULL;
+    destruir_rota(aero->rota);
+    aero->rota.head = aero->rota.tail = aero->rota.curr = NULL;
+    aero->rota.len = 0;
+
+    devolver_slot(ctrl, aero_idx);
+}
+
+// Troca o trecho da rota a partir de `no_setor` (setor com prazo expirado) por um desvio pela
+// topologia até o mesmo destino, se a nova demanda mantiver o estado seguro
+static bool desviar_rota(controle_t* ctrl, int aero_idx, rota_node_t* antes, rota_node_t* no_setor) {
+    aeronave_t* aero = &ctrl->aeronaves[aero_idx];
+    rota_t* rota = &aero->rota;
+    int origem = ctrl->setor_ocupado[aero_idx];
+    int evitar = no_setor->setor->setor_index;
+    int destino = rota->tail->setor->setor_index;
+
+    if (ctrl->planejador == NULL || antes == NULL || origem == -1 || destino == evitar) return false;
+
+    size_t m = ctrl->num_setores;
+    int* caminho = ctrl->rascunho;
+    size_t len = planejador_desvio(ctrl->planejador, origem, destino, evitar, caminho);
+    if (len < 2) return false;
+
+    // Demanda anterior das colunas do desvio (setores já percorridos têm need consumida)
+    int* max_antes = ctrl->rascunho + m;
+    int* need_antes = ctrl->rascunho + 2 * m;
+    for (size_t i = 1; i < len; i++) {
+        max_antes[i] = banqueiro_max(ctrl->banqueiro, aero_idx, caminho[i]);
+        need_antes[i] = banqueiro_necessidade(ctrl->banqueiro, aero_idx, caminho[i]);
+    }
+
+    // O trecho antigo (ainda não percorrido) deixa de ser demanda e o desvio passa a ser
+    for (rota_node_t* curr = no_setor; curr != NULL; curr = curr->next) {
+        banqueiro_definir_max(ctrl->banqueiro, aero_idx, curr->setor->setor_index, 0);
+    }
+    for (size_t i = 1; i < len; i++) {
+        banqueiro_definir_max(ctrl->banqueiro, aero_idx, caminho[i], 1);
+    }
+
+    // Aumentar a demanda declarada pode tornar o estado inseguro: nesse caso desfaz
+    if (!banqueiro_estado_seguro(ctrl->banqueiro)) {
+        for (size_t i = 1; i < len; i++) {
+            banqueiro_definir_max(ctrl->banqueiro, aero_idx, caminho[i], max_antes[i]);
+            banqueiro_definir_necessidade(ctrl->banqueiro, aero_idx, caminho[i], need_antes[i]);
         }
+        for (rota_node_t* curr = no_setor; curr != NULL; curr = curr->next) {
+            banqueiro_definir_max(ctrl->banqueiro, aero_idx, curr->setor->setor_index, 1);
+        }
+        planejador_remover_rota(ctrl->planejador, caminho + 1, len - 1);
+        return false;
+    }
 
-        pthread_mutex_unlock(&ctrl->banker_lock);
+    // Substitui os nós do trecho antigo pelos do desvio (max_antes já não é usado: vira o bloco)
+    remover_demanda_trecho(ctrl, no_setor, max_antes);
+    size_t removidos = 0;
+    for (rota_node_t* curr = no_setor; curr != NULL;) {
+        rota_node_t* prox = curr->next;
+        removidos++;
+        memoria_liberar(curr);
+        curr = prox;
     }
 
-    printf_timestamped("[BANQUEIRO] Todas as aeronaves finalizaram. Encerrando thread do banqueiro.\n");
+    rota_t desvio = criar_rota_caminho(ctrl->setores, caminho + 1, len - 1);
+    antes->next = desvio.head;
+    rota->tail = desvio.tail != NULL ? desvio.tail : antes;
+    rota->curr = desvio.head;
+    rota->len = rota->len - removidos + desvio.len;
 
-    return NULL;
+    ctrl->estatisticas.desvios++;
+    return true;
+}
+
+// A solicitação de `setor_idx` expirou e a aeronave já saiu da fila: define o próximo setor a
+// tentar. Com topologia, tenta um desvio que evita o setor; sem topologia adia o setor para
+// depois do seguinte (a rota não exige adjacência, e o conjunto de setores, logo a demanda
+// no banqueiro, não muda). Sem alternativa, tenta o mesmo setor de novo.
+static void reencaminhar_aeronave(controle_t* ctrl, int aero_idx) {
+    rota_t* rota = &ctrl->aeronaves[aero_idx].rota;
+
+    // O setor cancelado é o nó imediatamente antes de rota.curr (a aeronave já avançou)
+    rota_node_t* antes = NULL;
+    rota_node_t* no_setor = rota->head;
+    while (no_setor != NULL && no_setor->next != rota->curr) {
+        antes = no_setor;
+        no_setor = no_setor->next;
+    }
+    if (no_setor == NULL) return;
+
+    if (desviar_rota(ctrl, aero_idx, antes, no_setor)) {
+        printf_timestamped("[BANQUEIRO] Aeronave %s desviada (rota com %zu setores).\n", ctrl->aeronaves[aero_idx].id, rota->len);
+    } else if (ctrl->planejador == NULL && no_setor->next != NULL) {
+        setor_t* tmp = no_setor->setor;
+        no_setor->setor = no_setor->next->setor;
+        no_setor->next->setor = tmp;
+        ctrl->estatisticas.reordenacoes++;
+        printf_timestamped("[BANQUEIRO] Aeronave %s adia o setor %s.\n", ctrl->aeronaves[aero_idx].id, tmp->id);
+    }
+    rota->curr = antes == NULL ? rota->head : antes->next;
+
+    ctrl->componentes_desatualizadas = true;
+    ctrl->componentes_demanda_nova = true;
+}
+
+// Confirma à aeronave (e somente a ela) que a solicitação foi cancelada
+static void notificar_cancelamento(controle_t* ctrl, int aero_idx) {
+    aeronave_estado_t* estado = &ctrl->estados[aero_idx];
+
+    long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
+    estado->cancelamento_confirmado = true;
+    pthread_cond_signal(&estado->concessao_cond);
+    perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+}
+
+static void repassar_setor(controle_t* ctrl, int setor_idx);
+
+// Concede o setor à aeronave da fila se a concessão for segura. Com `repassar`, a origem liberada
+// (sem lookahead a aeronave deixa a origem ao entrar no destino) é repassada em seguida à sua fila.
+static bool conceder_candidato(controle_t* ctrl, setor_t* setor, int aero_idx, bool repassar) {
+    // No lookahead a aeronave só libera a origem ao entrar no destino (reserva)
+    int setor_origem_idx = ctrl->lookahead ? -1 : ctrl->setor_ocupado[aero_idx];
+
+    if (!setor_tenta_conceder_seguro(ctrl, aero_idx, setor->setor_index, setor_origem_idx)) return false;
+
+    printf_timestamped("[BANQUEIRO] Concedeu setor %s para aeronave %s.\n", setor->id, ctrl->aeronaves[aero_idx].id);
+
+    sair_fila(setor, &ctrl->aeronaves[aero_idx]);
+    ctrl->setor_ocupado[aero_idx] = setor->setor_index;
+    ctrl->estatisticas.concessoes++;
+    if (repassar) ctrl->estatisticas.repasses++;
+    if (ctrl->invariantes != NULL) {
+        invariantes_concessao(ctrl->invariantes, aero_idx, setor->setor_index);
+    }
+
+    long long inicio = perfil_inicio();
+    notificar_concessao(ctrl, aero_idx, setor->setor_index);
+    perfil_fase(PERFIL_FASE_NOTIFICACAO, inicio);
+
+    // A cadeia termina: cada repasse retira uma aeronave de uma fila
+    if (repassar && setor_origem_idx != -1) {
+        repassar_setor(ctrl, setor_origem_idx);
+    }
+    return true;
+}
+
+// Pontuação de vazão de uma aeronave da fila, a partir da rota e do estado do controle. rota.curr
+// já passou do setor pedido: o que resta depois dele é a demanda que a aeronave ainda segura
+static double pontuar_candidato(const controle_t* ctrl, int aero_idx) {
+    const aeronave_t* aero = &ctrl->aeronaves[aero_idx];
+    size_t restante = 0;
+    for (const rota_node_t* curr = aero->rota.curr; curr != NULL; curr = curr->next) restante++;
+
+    // Aeronaves à espera da origem que a concessão libera (no lookahead, ao fim do voo atual)
+    int origem = ctrl->setor_ocupado[aero_idx];
+    double desbloqueadas = origem != -1 ? (double)ctrl->setores[origem].fila_len : 0.0;
+    double m = (double)ctrl->num_setores;
+
+    switch (ctrl->selecao) {
+        case SELECAO_ROTA_CURTA:
+            return -(double)restante;
+        case SELECAO_MENOS_BLOQUEIO:
+            return desbloqueadas * (m + 1.0) - (double)restante;
+        case SELECAO_MISTA: {
+            // Ambos os termos em [0, 1]
+            double vazao = 0.5 * desbloqueadas / (desbloqueadas + 1.0) + 0.5 * (1.0 - (double)restante / m);
+            return ctrl->peso_prioridade * (double)aero->prioridade / 1000.0 + (1.0 - ctrl->peso_prioridade) * vazao;
+        }
+        case SELECAO_FILA:
+        default:
+            return 0.0;
+    }
+}
+
+// Maior pontuação primeiro; empate pela posição na fila (a ordem da política)
+static int comparar_candidatos(const void* a, const void* b) {
+    const candidato_t* x = (const candidato_t*)a;
+    const candidato_t* y = (const candidato_t*)b;
+    if (x->pontuacao != y->pontuacao) return x->pontuacao > y->pontuacao ? -1 : 1;
+    return x->posicao - y->posicao;
 }
 
-bool is_safe(controle_t* ctrl, int temp_available[], int temp_allocation[][ctrl->num_setores], int temp_need[][ctrl->num_setores]) {
-    int work[ctrl->num_setores];
-    bool finish[ctrl->num_aeronaves];
-    size_t count = 0;
-    
-    // Inicialização
-    for (size_t j = 0; j < ctrl->num_setores; j++) work[j] = temp_available[j];
-    for (size_t p = 0; p < ctrl->num_aeronaves; p++) finish[p] = false;
-
-    // Busca por sequência segura
-    while (count < ctrl->num_aeronaves) {
-        bool found = false;
-        for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
-            if (finish[p] == false) {
-                size_t j;
-                // Verifica se Need[p] <= Work
-                for (j = 0; j < ctrl->num_setores; j++) {
-                    if (temp_need[p][j] > work[j]) break;
+// Tenta as aeronaves da fila na ordem da seleção, enquanto houver vaga. Retorna false (nada feito)
+// se os candidatos não couberem na pilha de decisões
+static bool conceder_fila_selecao(controle_t* ctrl, setor_t* setor, bool repassar) {
+    if (ctrl->candidatos_usados + setor->fila_len > ctrl->candidatos_cap) return false;
+
+    candidato_t* candidatos = ctrl->candidatos + ctrl->candidatos_usados;
+    size_t k = 0;
+    for (int aero_idx = setor->fila_inicio; aero_idx != -1; aero_idx = ctrl->fila_nos[aero_idx].prox) {
+        candidatos[k].aero_index = aero_idx;
+        candidatos[k].posicao = (int)k;
+        candidatos[k].pontuacao = pontuar_candidato(ctrl, aero_idx);
+        k++;
+    }
+    qsort(candidatos, k, sizeof(candidato_t), comparar_candidatos);
+    int menor = (int)k;
+    for (size_t i = k; i-- > 0;) {
+        candidatos[i].menor_posicao_seguinte = menor;
+        if (candidatos[i].posicao < menor) menor = candidatos[i].posicao;
+    }
+
+    ctrl->candidatos_usados += k;
+    ctrl->estatisticas.selecoes++;
+    ctrl->estatisticas.candidatos_avaliados += k;
+
+    for (size_t i = 0; i < k; i++) {
+        if (banqueiro_disponivel(ctrl->banqueiro, setor->setor_index) == 0) break;
+
+        // Um repasse em cascata pode ter atendido o candidato por esta mesma fila
+        int aero_idx = candidatos[i].aero_index;
+        if (ctrl->fila_nos[aero_idx].setor_index != setor->setor_index) continue;
+
+        // Fora da ordem: algum candidato à frente na fila só seria tentado depois deste
+        bool fora_da_fila = candidatos[i].menor_posicao_seguinte < candidatos[i].posicao;
+        if (conceder_candidato(ctrl, setor, aero_idx, repassar) && fora_da_fila) {
+            ctrl->estatisticas.fora_da_fila++;
+        }
+    }
+
+    ctrl->candidatos_usados -= k;
+    return true;
+}
+
+// Concede o setor às aeronaves seguras da sua fila enquanto houver vaga: pela seleção configurada
+// quando há mais de uma candidata, senão na ordem da política (maior chave primeiro)
+static void conceder_fila(controle_t* ctrl, setor_t* setor, bool repassar) {
+    if (ctrl->selecao != SELECAO_FILA && setor->fila_len > 1 && conceder_fila_selecao(ctrl, setor, repassar)) return;
+
+    int aero_idx = setor->fila_inicio;
+    while (aero_idx != -1 && banqueiro_disponivel(ctrl->banqueiro, setor->setor_index) > 0) {
+        int prox = ctrl->fila_nos[aero_idx].prox; // lido antes de sair_fila desligar o nó
+        conceder_candidato(ctrl, setor, aero_idx, repassar);
+
+        // Um repasse em cascata pode ter atendido `prox` por esta mesma fila (o setor voltou a ser
+        // liberado na cadeia): o índice guardado ficou velho, então recomeça do início da fila
+        if (prox != -1 && ctrl->fila_nos[prox].setor_index != setor->setor_index) {
+            prox = setor->fila_inicio;
+        }
+        aero_idx = prox;
+    }
+}
+
+// Repasse direto do setor que acabou de ser liberado, sem esperar a varredura do fim da passada.
+// As componentes só podem estar desatualizadas por remoções (liberações, aposentadorias): cada
+// componente guardada é então a união de componentes atuais e a checagem continua correta. Com
+// demanda nova (admissão, desvio), o repasse fica para a varredura, que reconstrói antes.
+static void repassar_setor(controle_t* ctrl, int setor_idx) {
+    setor_t* setor = &ctrl->setores[setor_idx];
+    if (setor->fila_len == 0 || ctrl->componentes_demanda_nova) return;
+
+    conceder_fila(ctrl, setor, true);
+}
+
+// Consome as mensagens da caixa postal. Retorna true se alguma mensagem foi processada.
+static bool processar_mensagens(controle_t* ctrl) {
+    mensagem_t* msg = caixa_postal_drenar(&ctrl->caixa);
+    bool processou = msg != NULL;
+
+    while (msg != NULL) {
+        mensagem_t* prox = msg->prox;
+        setor_t* setor = msg->setor_index != -1 ? &ctrl->setores[msg->setor_index] : NULL;
+
+        switch (msg->tipo) {
+            case MSG_SOLICITACAO:
+                if (!entrar_fila(setor, &ctrl->aeronaves[msg->aero_index]) && ctrl->invariantes != NULL) {
+                    invariantes_violacao(ctrl->invariantes, "solicitação do setor %s pela aeronave %s, que já está na fila do setor %d",
+                                         setor->id, ctrl->aeronaves[msg->aero_index].id, ctrl->fila_nos[msg->aero_index].setor_index);
                 }
-                
-                // Se Need[p] <= Work para todos os recursos, então encontrou um processo p seguro
-                if (j == ctrl->num_setores) {
-                    // Simula a conclusão: Work = Work + Allocation[p]
-                    for (size_t k = 0; k < ctrl->num_setores; k++) {
-                        work[k] += temp_allocation[p][k];
-                    }
-                    finish[p] = true;
-                    found = true;
-                    count++;
+                break;
+
+            case MSG_ADMISSAO:
+                printf_timestamped("[BANQUEIRO] Aeronave %s admitida no slot %d.\n", ctrl->aeronaves[msg->aero_index].id, msg->aero_index);
+                controle_definir_demanda(ctrl, msg->aero_index, &ctrl->aeronaves[msg->aero_index].rota);
+                break;
+
+            case MSG_APOSENTADORIA:
+                aposentar_aeronave(ctrl, msg->aero_index, msg->setor_index);
+                if (msg->setor_index != -1) {
+                    repassar_setor(ctrl, msg->setor_index);
                 }
+                break;
+
+            case MSG_ENTRADA_ESCALA: {
+                // Segura por construção (bilhetes executados em ordem): apenas aplica no estado
+                printf_timestamped("[BANQUEIRO] Aeronave %s entrou no setor %s pela escala.\n", ctrl->aeronaves[msg->aero_index].id, setor->id);
+                banqueiro_pedido_t pedido = {
+                    .processo = msg->aero_index,
+                    .recurso = msg->setor_index,
+                    .quantidade = 1,
+                    .recurso_liberado = ctrl->setor_ocupado[msg->aero_index],
+                };
+                banqueiro_aplicar(ctrl->banqueiro, &pedido);
+                ctrl->setor_ocupado[msg->aero_index] = msg->setor_index;
+                break;
             }
+
+            case MSG_CANCELAMENTO:
+                // Se já foi concedido a notificação está a caminho e a aeronave a aceitará
+                if (ctrl->fila_nos[msg->aero_index].setor_index == msg->setor_index) {
+                    printf_timestamped("[BANQUEIRO] Aeronave %s cancelou a espera pelo setor %s.\n", ctrl->aeronaves[msg->aero_index].id, setor->id);
+                    sair_fila(setor, &ctrl->aeronaves[msg->aero_index]);
+                    reencaminhar_aeronave(ctrl, msg->aero_index);
+                    ctrl->estatisticas.cancelamentos++;
+                    notificar_cancelamento(ctrl, msg->aero_index);
+                }
+                break;
+
+            case MSG_LIBERACAO:
+                printf_timestamped("[BANQUEIRO] Aeronave %s liberou setor %s.\n", ctrl->aeronaves[msg->aero_index].id, setor->id);
+                // ** CHAMADA AO CORAÇÃO DO BANQUEIRO **
+                bool liberou = banqueiro_alocado(ctrl->banqueiro, msg->aero_index, msg->setor_index) > 0;
+                liberar_recurso_banqueiro(ctrl, msg->aero_index, msg->setor_index);
+                if (ctrl->setor_ocupado[msg->aero_index] == msg->setor_index) {
+                    ctrl->setor_ocupado[msg->aero_index] = -1;
+                }
+                if (ctrl->invariantes != NULL) {
+                    invariantes_liberacao(ctrl->invariantes, msg->aero_index, msg->setor_index);
+                }
+                // O setor liberado já foi percorrido: a aresta aeronave–setor deixa de existir
+                ctrl->componentes_desatualizadas = true;
+                // Sem lookahead a vaga já saiu na concessão do destino (e foi repassada ali)
+                if (liberou) {
+                    repassar_setor(ctrl, msg->setor_index);
+                }
+                break;
         }
-        // Se nenhum processo foi encontrado nesta iteração, o sistema não está em um estado seguro
-        if (found == false && count < ctrl->num_aeronaves){
-            return false;
+
+        caixa_postal_consumida(msg);
+        msg = prox;
+    }
+
+    return processou;
+}
+
+void controle_reconstruir_componentes(controle_t* ctrl) {
+    componentes_t* comp = &ctrl->componentes;
+
+    componentes_limpar(comp);
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        if (!ctrl->aeronave_ativa[p]) continue;
+
+        for (rota_node_t* curr = ctrl->aeronaves[p].rota.head; curr != NULL; curr = curr->next) {
+            int j = curr->setor->setor_index;
+            if (banqueiro_necessidade(ctrl->banqueiro, (int)p, j) > 0 || banqueiro_alocado(ctrl->banqueiro, (int)p, j) > 0) {
+                componentes_unir(comp, (int)p, j);
+            }
         }
     }
-    return true;
+    componentes_finalizar(comp);
+
+    if (comp->maior_componente > ctrl->estatisticas.maior_componente) {
+        ctrl->estatisticas.maior_componente = comp->maior_componente;
+    }
+    ctrl->componentes_desatualizadas = false;
+    ctrl->componentes_demanda_nova = false;
 }
 
-// Tenta a alocação provisória e verifica a segurança
-bool setor_tenta_conceder_seguro(controle_t* ctrl, int aero_idx, int setor_destino_idx, int setor_origem_idx) {
-    printf_timestamped("[BANQUEIRO] Tentando conceder setor %d para aeronave %d...\n", setor_destino_idx, aero_idx);
-    // Checagem rápida de necessidade e disponibilidade
-    if (ctrl->need[aero_idx][setor_destino_idx] <= 0 || ctrl->available[setor_destino_idx] < 1) return false;
+// Percorre as filas dos setores concedendo, em cada setor, as primeiras aeronaves seguras até a capacidade
+static void conceder_setores(controle_t* ctrl) {
+    if (ctrl->componentes_desatualizadas) {
+        long long inicio = perfil_inicio();
+        controle_reconstruir_componentes(ctrl);
+        perfil_fase(PERFIL_FASE_COMPONENTES, inicio);
+    }
 
-    size_t num_aeronaves = ctrl->num_aeronaves;
-    size_t num_setores = ctrl->num_setores;
+    for (size_t i = 0; i < ctrl->num_setores; i++) {
+        setor_t* setor = &ctrl->setores[i];
+        if (setor->fila_len == 0) continue;
 
-    // 1. Criação das Matrizes Temporárias (Cópia do estado ATUAL)
-    int temp_available[num_setores];
-    int temp_allocation[num_aeronaves][num_setores];
-    int temp_need[num_aeronaves][num_setores];
+        conceder_fila(ctrl, setor, false);
+    }
+}
 
-    memcpy(temp_available, ctrl->available, num_setores * sizeof(int));
-    for (size_t i = 0; i < num_aeronaves; i++) {
-        // Copia a linha [i] da matriz global para a linha [i] da matriz temporária local
-        memcpy(temp_allocation[i], ctrl->allocation[i], num_setores * sizeof(int));
-        memcpy(temp_need[i], ctrl->need[i], num_setores * sizeof(int));
+// Pede a pausa no horário do checkpoint e grava o instantâneo assim que o sistema estiver parado
+static void verificar_checkpoint(controle_t* ctrl) {
+    long long agora = tempo_monotonico_ns();
+    if (!atomic_load(&ctrl->pausa)) {
+        if (agora >= ctrl->proximo_checkpoint_ns) {
+            ctrl->inicio_pausa_ns = agora;
+            atomic_store(&ctrl->pausa, true);
+        }
+        return;
     }
 
+    // Uma aeronave estacionada não se move até a pausa acabar; as da fila só andam por concessão
+    // (que é este thread quem faz); as concluídas já enviaram a última liberação
+    pthread_mutex_lock(&ctrl->pausa_lock);
+    size_t paradas = ctrl->estacionadas;
+    pthread_mutex_unlock(&ctrl->pausa_lock);
+
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        if (ctrl->fila_nos[p].setor_index != -1) {
+            paradas++;
+            continue;
+        }
+        aeronave_estado_t* estado = &ctrl->estados[p];
+        long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
+        if (estado->finished) paradas++;
+        perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+    }
+
+    // Lida depois da contagem: uma mensagem enviada antes de a aeronave parar ainda está aqui
+    if (paradas < ctrl->num_aeronaves || !caixa_postal_vazia(&ctrl->caixa)) return;
+
+    long long inicio = tempo_monotonico_ns();
+    if (checkpoint_gravar(ctrl, ctrl->arquivo_checkpoint)) {
+        long long fim = tempo_monotonico_ns();
+        ctrl->checkpoints++;
+        ctrl->gravacao_total_ns += fim - inicio;
+        ctrl->pausa_total_ns += fim - ctrl->inicio_pausa_ns;
+        printf_timestamped("[BANQUEIRO] Checkpoint gravado em %s.\n", ctrl->arquivo_checkpoint);
+    } else {
+        fprintf(stderr, "ERRO: falha ao gravar o checkpoint em %s; a simulação continua.\n", ctrl->arquivo_checkpoint);
+    }
+
+    ctrl->proximo_checkpoint_ns = tempo_monotonico_ns() + ctrl->checkpoint_intervalo_ns;
+    pthread_mutex_lock(&ctrl->pausa_lock);
+    atomic_store(&ctrl->pausa, false);
+    pthread_cond_broadcast(&ctrl->pausa_cond);
+    pthread_mutex_unlock(&ctrl->pausa_lock);
+}
+
+void controle_ponto_seguro(controle_t* ctrl) {
+    if (!atomic_load_explicit(&ctrl->pausa, memory_order_acquire)) return;
 
-    // Libera o recurso do setor de origem, se aplicável
-    if (setor_origem_idx != -1) {
-        temp_available[setor_origem_idx] += 1;
-        temp_allocation[aero_idx][setor_origem_idx] -= 1;
+    pthread_mutex_lock(&ctrl->pausa_lock);
+    if (atomic_load(&ctrl->pausa)) {
+        ctrl->estacionadas++;
+        caixa_postal_acordar(&ctrl->caixa);
+        while (atomic_load(&ctrl->pausa)) {
+            pthread_cond_wait(&ctrl->pausa_cond, &ctrl->pausa_lock);
+        }
+        ctrl->estacionadas--;
     }
-    
-    // Simular a alocação (temporariamente, na memória do ctrl)
-    temp_available[setor_destino_idx] -= 1;
-    temp_allocation[aero_idx][setor_destino_idx] += 1;
-    temp_need[aero_idx][setor_destino_idx] -= 1;
+    pthread_mutex_unlock(&ctrl->pausa_lock);
+}
+
+void* banqueiro_thread(void* arg) {
+    controle_t* ctrl = (controle_t*)arg;
+
+    // Loop para monitorar as solicitações
+    while (true) {
+        printf_timestamped("[BANQUEIRO] Aguardando novas solicitações...\n");
+        long long inicio_espera = perfil_inicio();
+        if (!caixa_postal_aguardar(&ctrl->caixa, 5)) {
+            printf_timestamped("[BANQUEIRO] Timeout de espera atingido. Verificando novamente...\n");
+        }
+        perfil_fase(PERFIL_FASE_ESPERA, inicio_espera);
+        long long inicio_iteracao = perfil_inicio();
 
-    // Executar a checagem de segurança (is_safe)
-    bool res = is_safe(ctrl, temp_available, temp_allocation, temp_need);
-    if (res) {
-        // Se seguro, efetiva a alocação nas matrizes reais
-        if (setor_origem_idx != -1) {
-            ctrl->available[setor_origem_idx] += 1;
-            ctrl->allocation[aero_idx][setor_origem_idx] -= 1;
+        // Lido ANTES de drenar: se já foi pedido, todas as mensagens finais já estão na caixa
+        bool encerrar = atomic_load(&ctrl->encerrar);
+
+        long long adquirido_ns = perfil_lock(&ctrl->banker_lock, PERFIL_LOCK_BANQUEIRO);
+
+        printf_timestamped("[BANQUEIRO] Acordado para processar solicitações.\n");
+        long long inicio = perfil_inicio();
+        bool processou = processar_mensagens(ctrl);
+        perfil_fase(PERFIL_FASE_MENSAGENS, inicio);
+
+        if (processou) {
+            inicio = perfil_inicio();
+            conceder_setores(ctrl);
+            perfil_fase(PERFIL_FASE_VARREDURA, inicio);
+        }
+
+        if (ctrl->arquivo_checkpoint != NULL) {
+            verificar_checkpoint(ctrl);
+        }
+        if (ctrl->invariantes != NULL) {
+            invariantes_passada(ctrl->invariantes);
         }
-        ctrl->available[setor_destino_idx] -= 1;
-        ctrl->allocation[aero_idx][setor_destino_idx] += 1;
-        ctrl->need[aero_idx][setor_destino_idx] -= 1;
+
+        perfil_unlock(&ctrl->banker_lock, PERFIL_LOCK_BANQUEIRO, adquirido_ns);
+        perfil_fase(PERFIL_FASE_ITERACAO, inicio_iteracao);
+
+        if (encerrar) break;
     }
 
-    return res;
+    printf_timestamped("[BANQUEIRO] Todas as aeronaves finalizaram. Encerrando thread do banqueiro.\n");
+
+    return NULL;
+}
+
+bool is_safe(controle_t* ctrl) {
+    return banqueiro_estado_seguro(ctrl->banqueiro);
+}
+
+// Tenta a alocação provisória e verifica a segurança
+bool setor_tenta_conceder_seguro(controle_t* ctrl, int aero_idx, int setor_destino_idx, int setor_origem_idx) {
+    printf_timestamped("[BANQUEIRO] Tentando conceder setor %d para aeronave %d...\n", setor_destino_idx, aero_idx);
+
+    // A biblioteca aplica o pedido no próprio estado, checa a segurança e desfaz se inseguro.
+    // Origem e destino pertencem à rota, logo à componente do solicitante: as demais aeronaves
+    // não compartilham setores com ela e ficam fora da checagem.
+    banqueiro_pedido_t pedido = {
+        .processo = aero_idx,
+        .recurso = setor_destino_idx,
+        .quantidade = 1,
+        .recurso_liberado = setor_origem_idx,
+    };
+
+    size_t num_membros;
+    const int* membros = componentes_membros(&ctrl->componentes, aero_idx, &num_membros);
+    ctrl->estatisticas.verificacoes_seguranca++;
+    ctrl->estatisticas.aeronaves_verificadas += num_membros;
+
+    long long inicio = perfil_inicio();
+    bool seguro = banqueiro_conceder_subconjunto(ctrl->banqueiro, &pedido, membros, num_membros);
+    perfil_fase(PERFIL_FASE_SEGURANCA, inicio);
+
+    return seguro;
 }
 
 // Libera o recurso e atualiza as matrizes
 void liberar_recurso_banqueiro(controle_t* ctrl, int aero_id, int setor_idx) {
-    // Se o setor estava alocado, libera
-    if (ctrl->allocation[aero_id][setor_idx] > 0) {
-        ctrl->available[setor_idx] += ctrl->allocation[aero_id][setor_idx];
-        ctrl->allocation[aero_id][setor_idx] = 0;
-        // Restaura a necessidade (necessário se for usar o algoritmo de solicitação completo)
-        //ctrl->need[aero_id][setor_idx] = ctrl->max[aero_id][setor_idx]; 
+    // Se o setor estava alocado, libera (a necessidade não é restaurada: o setor já foi percorrido)
+    int alocado = banqueiro_alocado(ctrl->banqueiro, aero_id, setor_idx);
+    if (alocado > 0) {
+        banqueiro_liberar(ctrl->banqueiro, aero_id, setor_idx, alocado);
     }
 }
 
-bool existe_aerothread_alive(controle_t* ctrl) {
-    if (ctrl == NULL) return false;
-    if (ctrl->aeronaves == NULL) {
-        return false;
+void controle_definir_demanda(controle_t* ctrl, int aero_idx, const rota_t* rota) {
+    for (rota_node_t* curr = rota->head; curr != NULL; curr = curr->next) {
+        banqueiro_definir_max(ctrl->banqueiro, aero_idx, curr->setor->setor_index, 1);
+    }
+    ctrl->aeronave_ativa[aero_idx] = true;
+    ctrl->componentes_desatualizadas = true;
+    ctrl->componentes_demanda_nova = true;
+}
+
+int controle_reservar_slot(controle_t* ctrl) {
+    long long adquirido_ns = perfil_lock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS);
+    while (ctrl->num_slots_livres == 0) {
+        perfil_cond_wait(&ctrl->slots_cond, &ctrl->slots_lock, PERFIL_LOCK_SLOTS, &adquirido_ns);
     }
+    int aero_idx = ctrl->slots_livres[--ctrl->num_slots_livres];
+    perfil_unlock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS, adquirido_ns);
 
-    for (size_t i = 0; i < ctrl->num_aeronaves; i++) {
-        if (!ctrl->aeronaves[i].finished) {
-            return true;
+    return aero_idx;
+}
+
+void controle_aguardar_slots_livres(controle_t* ctrl) {
+    long long adquirido_ns = perfil_lock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS);
+    while (ctrl->num_slots_livres < ctrl->num_aeronaves) {
+        perfil_cond_wait(&ctrl->slots_cond, &ctrl->slots_lock, PERFIL_LOCK_SLOTS, &adquirido_ns);
+    }
+    perfil_unlock(&ctrl->slots_lock, PERFIL_LOCK_SLOTS, adquirido_ns);
+}
+
+void controle_relatorio_cancelamentos(const controle_t* ctrl) {
+    const estatisticas_operacao_t* est = &ctrl->estatisticas;
+
+    printf("Prazo por setor: %u ms | cancelamentos: %zu (desvios: %zu, reordenações: %zu, nova tentativa: %zu)\n",
+           ctrl->prazo_setor_ms, est->cancelamentos, est->desvios, est->reordenacoes,
+           est->cancelamentos - est->desvios - est->reordenacoes);
+}
+
+void controle_relatorio_seguranca(const controle_t* ctrl) {
+    const estatisticas_operacao_t* est = &ctrl->estatisticas;
+
+    printf("Checagens de segurança: %zu | aeronaves por checagem: %.2f de %zu | maior componente: %zu\n",
+           est->verificacoes_seguranca,
+           est->verificacoes_seguranca > 0 ? (double)est->aeronaves_verificadas / (double)est->verificacoes_seguranca : 0.0,
+           ctrl->num_aeronaves, est->maior_componente);
+    printf("Concessões: %zu | por repasse direto na liberação: %zu (%.1f%%)\n", est->concessoes, est->repasses,
+           est->concessoes > 0 ? 100.0 * (double)est->repasses / (double)est->concessoes : 0.0);
+}
+
+void controle_relatorio_selecao(const controle_t* ctrl) {
+    if (ctrl->selecao == SELECAO_FILA || ctrl->estatisticas.selecoes == 0) return;
+
+    const estatisticas_operacao_t* est = &ctrl->estatisticas;
+    printf("Seleção de concessões: %s", selecao_nome(ctrl->selecao));
+    if (ctrl->selecao == SELECAO_MISTA) {
+        printf(" (peso da prioridade %.2f)", ctrl->peso_prioridade);
+    }
+    printf(" | decisões: %zu | candidatas por decisão: %.2f | concessões fora da ordem da fila: %zu (%.1f%%)\n",
+           est->selecoes, est->selecoes > 0 ? (double)est->candidatos_avaliados / (double)est->selecoes : 0.0, est->fora_da_fila,
+           est->concessoes > 0 ? 100.0 * (double)est->fora_da_fila / (double)est->concessoes : 0.0);
+}
+
+void controle_relatorio_esperas(const controle_t* ctrl) {
+    size_t giro = 0;
+    size_t bloqueio = 0;
+    long long soma_latencia_ns = 0;
+    size_t com_latencia = 0;
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        const aeronave_estado_t* estado = &ctrl->estados[p];
+        giro += estado->esperas_giro;
+        bloqueio += estado->esperas_bloqueio;
+        if (estado->latencia_curta_ns > 0) {
+            soma_latencia_ns += estado->latencia_curta_ns;
+            com_latencia++;
         }
     }
-    return false;
-}
\ No newline at end of file
+
+    // Na escala as entradas seguem os bilhetes, sem esperar concessões
+    size_t total = giro + bloqueio;
+    if (total == 0) return;
+    printf("Esperas por concessão: %zu | resolvidas no giro: %zu (%.1f%%) | giro máximo: %lld us | latência das concessões curtas: %.1f us\n",
+           total, giro, total > 0 ? 100.0 * (double)giro / (double)total : 0.0, ctrl->giro_max_ns / 1000,
+           com_latencia > 0 ? (double)soma_latencia_ns / (double)com_latencia / 1000.0 : 0.0);
+}
+
+void controle_relatorio_checkpoints(const controle_t* ctrl) {
+    size_t k = ctrl->checkpoints;
+    printf("Checkpoints gravados: %zu", k);
+    if (k > 0) {
+        printf(" | pausa média: %.2f ms | gravação média: %.2f ms",
+               (double)ctrl->pausa_total_ns / (double)k / 1e6, (double)ctrl->gravacao_total_ns / (double)k / 1e6);
+    }
+    printf("\n");
+}
+
+void controle_encerrar(controle_t* ctrl) {
+    atomic_store(&ctrl->encerrar, true);
+    caixa_postal_acordar(&ctrl->caixa);
+}
@@ -2,31 +2,183 @@
 #define CONTROLE_H
 
 #include "setor.h"
+#include "config.h"
+#include "politica.h"
+#include "caixa_postal.h"
+#include "topologia.h"
+#include "banqueiro.h"
+#include "componentes.h"
+#include "utils.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
 #include <stdio.h>
 
 typedef struct setor setor_t;
 typedef struct aeronave aeronave_t;
+typedef struct aeronave_estado aeronave_estado_t;
+typedef struct fila_no fila_no_t;
+typedef struct rota rota_t;
+typedef struct escala escala_t;
+typedef struct invariantes invariantes_t;
+
+/**
+ * @brief Estatísticas acumuladas pelo banqueiro na operação contínua (a cada aposentadoria)
+ * 
+ * @param aposentadas aeronaves que concluíram a rota
+ * @param saltos total de setores percorridos pelas aeronaves aposentadas
+ * @param espera_total_ns soma das esperas por setor
+ * @param espera_media distribuição da espera média por setor de cada aeronave (ns)
+ * @param tempo_sistema distribuição do tempo entre chegada e aposentadoria (ns)
+ * @param verificacoes_seguranca execuções do algoritmo de segurança
+ * @param aeronaves_verificadas soma do tamanho das componentes verificadas
+ * @param maior_componente maior componente de conflito observada
+ * @param cancelamentos cancelamentos processados pelo banqueiro
+ * @param desvios cancelamentos resolvidos com um desvio pela topologia
+ * @param reordenacoes cancelamentos resolvidos adiando o setor para depois do seguinte na rota
+ * @param concessoes setores concedidos
+ * @param repasses concessões feitas por repasse direto no instante da liberação (sem esperar a varredura)
+ * @param selecoes decisões da seleção de concessão entre mais de uma aeronave na fila
+ * @param candidatos_avaliados soma das aeronaves pontuadas nessas decisões
+ * @param fora_da_fila concessões a uma aeronave escolhida à frente de outra que a fila atenderia antes
+ */
+typedef struct estatisticas_operacao {
+    size_t aposentadas;
+    size_t saltos;
+    long long espera_total_ns;
+    histograma_t espera_media;
+    histograma_t tempo_sistema;
+    size_t verificacoes_seguranca;
+    size_t aeronaves_verificadas;
+    size_t maior_componente;
+    size_t cancelamentos;
+    size_t desvios;
+    size_t reordenacoes;
+    size_t concessoes;
+    size_t repasses;
+    size_t selecoes;
+    size_t candidatos_avaliados;
+    size_t fora_da_fila;
+} estatisticas_operacao_t;
+
+/**
+ * @brief Aeronave da fila pontuada pela seleção de concessão
+ * 
+ * @param aero_index
+ * @param posicao posição na fila (desempate: a ordem da política)
+ * @param menor_posicao_seguinte menor posição entre os candidatos ordenados depois deste
+ * @param pontuacao maior pontuação é tentada primeiro
+ */
+typedef struct candidato {
+    int aero_index;
+    int posicao;
+    int menor_posicao_seguinte;
+    double pontuacao;
+} candidato_t;
 
 typedef struct controle {
     size_t num_aeronaves;
-    aeronave_t* aeronaves; // Ponteiro para as aeronaves gerenciadas
+    aeronave_t* aeronaves; // Ponteiro para as aeronaves gerenciadas (dados frios)
+    aeronave_estado_t* estados; // Ponteiro para o estado quente das aeronaves
 
     size_t num_setores;
     setor_t* setores; // Ponteiro para os setores gerenciados
     
-    // Matrizes do Banqueiro (alocadas dinamicamente)
-    int** max;         
-    int** allocation;  
-    int** need;        
-    int* available;   // 1 para disponível, 0 para alocado
+    // Estado do Banqueiro (libbanqueiro): processos = aeronaves, recursos = setores
+    // (capacidade[j] instâncias no setor j; cada aeronave demanda uma instância de cada setor da rota)
+    banqueiro_t* banqueiro;
+    int* capacidade;
+
+    // Componentes de conflito (aeronaves ligadas por setores com demanda ou alocação).
+    // Reconstruídas pelo banqueiro antes da próxima concessão quando uma admissão, liberação ou
+    // aposentadoria as desatualiza; concessões não criam arestas novas (só movem a alocação na rota)
+    componentes_t componentes;
+    bool componentes_desatualizadas;
+    // Demanda nova (admissão, desvio) desde a reconstrução: componentes podem ter de se fundir e
+    // não servem para o repasse direto. Só com remoções elas continuam válidas, apenas mais largas
+    bool componentes_demanda_nova;
+    bool* aeronave_ativa; // linhas com demanda registrada (lidas na reconstrução)
+
+    // Somente a thread do banqueiro altera as matrizes e as filas; ela mantém este lock
+    // durante cada passada para que leitores externos vejam um estado consistente
+    pthread_mutex_t banker_lock;
+
+    // Solicitações e liberações enviadas pelas aeronaves (MPSC, sem locks)
+    caixa_postal_t caixa;
+
+    // Setor ocupado por cada aeronave segundo o banqueiro (-1 se nenhum)
+    int* setor_ocupado;
+
+    // Pedido de encerramento da thread do banqueiro (após todas as aeronaves terminarem)
+    atomic_bool encerrar;
+
+    // Operação contínua: pilha de slots livres (linhas do banqueiro e aeronave_t reutilizáveis).
+    // O banqueiro devolve o slot ao processar a aposentadoria; o gerador de chegadas o retira.
+    int* slots_livres;
+    size_t num_slots_livres;
+    pthread_mutex_t slots_lock;
+    pthread_cond_t slots_cond;
+
+    // Escrito somente pelo banqueiro; lido após o encerramento da thread
+    estatisticas_operacao_t estatisticas;
+
+    // Planejador de rotas (NULL sem topologia); a demanda das rotas aposentadas é removida
+    planejador_t* planejador;
+
+    // Rascunho do banqueiro para desvios e remoção de demanda (3 * num_setores): alocado uma vez,
+    // pois o tamanho depende da topologia e não cabe com segurança na pilha da thread
+    int* rascunho;
+
+    // Gerador da instância (prioridades, rotas e a semente do gerador de cada aeronave): usado pela
+    // thread que monta a frota ou gera as chegadas e gravado no checkpoint com o sistema parado
+    aleatorio_t aleatorio;
+
+    // Escala compilada (NULL no controle online): as entradas pela escala chegam como MSG_ENTRADA_ESCALA
+    escala_t* escala;
+
+    // Prazo de cada espera por setor em ms (0 = sem prazo); ao expirar a aeronave é reencaminhada
+    unsigned int prazo_setor_ms;
 
-    pthread_mutex_t banker_lock; // Protege as matrizes do Banqueiro
+    // Janela máxima do giro das aeronaves antes de bloquear à espera da concessão (0 = bloqueia direto)
+    long long giro_max_ns;
 
-    pthread_cond_t new_request_cond; // Condição para novas solicitações
+    // Checkpoint periódico (arquivo NULL = desabilitado). No horário, o banqueiro pede a pausa; as
+    // aeronaves param no início do próximo salto (controle_ponto_seguro) e o instantâneo é gravado
+    // quando todas estão paradas, na fila sem concessão pendente ou concluídas e a caixa está vazia
+    const char* arquivo_checkpoint;
+    long long checkpoint_intervalo_ns;
+    long long proximo_checkpoint_ns;
+    long long inicio_pausa_ns;
+    atomic_bool pausa;
+    size_t estacionadas;
+    pthread_mutex_t pausa_lock;
+    pthread_cond_t pausa_cond;
+    size_t checkpoints;
+    long long pausa_total_ns;
+    long long gravacao_total_ns;
+
+    // Soak: usar_setor não dorme (permanência ~0) e o verificador de invariantes (NULL fora do
+    // soak) checa cada concessão e liberação e varre o estado entre as passadas
+    bool sem_permanencia;
+    invariantes_t* invariantes;
+
+    // Modo lookahead: a aeronave mantém o setor atual enquanto reserva o próximo,
+    // então a concessão não pode considerar o setor de origem como liberado
+    bool lookahead;
+
+    // Política de ordenação das filas e os nós das filas (um por aeronave, indexado por aero_index)
+    politica_t politica;
+    fila_no_t* fila_nos;
+
+    // Seleção entre as aeronaves seguras da fila. Os candidatos de cada decisão são empilhados em
+    // `candidatos` (os repasses em cascata abrem decisões aninhadas); sem espaço, vale a ordem da fila
+    selecao_tipo_t selecao;
+    double peso_prioridade;
+    candidato_t* candidatos;
+    size_t candidatos_cap;
+    size_t candidatos_usados;
 } controle_t;
 
 
@@ -36,34 +188,37 @@ typedef struct controle {
  * @param controle Ponteiro para a estrutura de controle a ser inicializada
  * @param num_aeronaves Número de aeronaves a serem gerenciadas
  * @param num_setores Número de setores a serem gerenciados
+ * @param config Parâmetros da execução (lookahead, política das filas)
  */
-void init_controle(controle_t* controle, size_t num_aeronaves, size_t num_setores);
+void init_controle(controle_t* controle, size_t num_aeronaves, size_t num_setores, const config_t* config);
 
 void destroy_controle(controle_t* controle);
 
 /**
  * @brief Thread de controle do banqueiro
  * 
+ * Drena a caixa postal, aplica as solicitações (entrada nas filas) e liberações,
+ * concede os setores seguros e notifica apenas as aeronaves contempladas.
+ * 
  * @param arg ponteiro para a struct controle_t
  * @return void* 
  */
 void* banqueiro_thread(void* arg);
 
 /**
- * @brief Algoritimo de segurança do banqueiro (Executado SOMENTE sob banker_lock)
+ * @brief Algoritimo de segurança do banqueiro sobre o estado atual (Executado SOMENTE sob banker_lock)
  * 
  * @param ctrl a struct do banqueiro
- * @param temp_available vetor temporário de recursos disponíveis
- * @param temp_allocation matriz temporária de alocações
- * @param temp_need matriz temporária de necessidades
  * @return true 
  * @return false 
  */
-bool is_safe(controle_t* ctrl, int temp_available[], int temp_allocation[][ctrl->num_setores], int temp_need[][ctrl->num_setores]);
+bool is_safe(controle_t* ctrl);
 
 /**
  * @brief Set the or tenta conceder seguro object
  * 
+ * A checagem considera apenas a componente de conflito da aeronave (componentes atualizadas).
+ * 
  * @param ctrl ponteiro para a struct controle_t
  * @param aero_idx aero_index da matriz do banqueiro
  * @param setor_destino_idx setor_index da matriz do banqueiro
@@ -83,12 +238,96 @@ bool setor_tenta_conceder_seguro(controle_t* ctrl, int aero_idx, int setor_desti
 void liberar_recurso_banqueiro(controle_t* ctrl, int aero_id, int setor_idx);
 
 /**
- * @brief Verifica se ainda existe alguma aerothread viva
+ * @brief Registra a demanda (max/need) de uma aeronave a partir da sua rota
+ * 
+ * Executado antes do início das threads ou SOMENTE pelo banqueiro.
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ * @param aero_idx aero_index da matriz do banqueiro
+ * @param rota rota da aeronave
+ */
+void controle_definir_demanda(controle_t* ctrl, int aero_idx, const rota_t* rota);
+
+/**
+ * @brief Refaz as componentes de conflito a partir dos setores da rota com demanda ou alocação
+ * 
+ * Executado antes do início das threads ou SOMENTE pelo banqueiro (antes de cada passada de
+ * concessões em que as componentes estejam desatualizadas).
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ */
+void controle_reconstruir_componentes(controle_t* ctrl);
+
+/**
+ * @brief Retira um slot livre para uma nova aeronave, bloqueando enquanto todos estiverem ocupados
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ * @return int aero_index do slot
+ */
+int controle_reservar_slot(controle_t* ctrl);
+
+/**
+ * @brief Bloqueia até todos os slots estarem livres (todas as aeronaves aposentadas)
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ */
+void controle_aguardar_slots_livres(controle_t* ctrl);
+
+/**
+ * @brief Imprime os cancelamentos por prazo e como foram resolvidos (desvio ou reordenação)
+ * 
+ * @param ctrl ponteiro para a struct controle_t (após o encerramento do banqueiro)
+ */
+void controle_relatorio_cancelamentos(const controle_t* ctrl);
+
+/**
+ * @brief Imprime quantas aeronaves, em média, cada checagem de segurança considerou
+ * (tamanho da componente de conflito) frente ao total de linhas do banqueiro, e quantas
+ * concessões saíram por repasse direto
+ * 
+ * @param ctrl ponteiro para a struct controle_t (após o encerramento do banqueiro)
+ */
+void controle_relatorio_seguranca(const controle_t* ctrl);
+
+/**
+ * @brief Imprime as decisões da seleção de concessão (nada com a seleção pela ordem da fila)
+ * 
+ * @param ctrl ponteiro para a struct controle_t (após o encerramento do banqueiro)
+ */
+void controle_relatorio_selecao(const controle_t* ctrl);
+
+/**
+ * @brief Imprime quantas esperas por concessão foram resolvidas no giro, sem bloquear
+ * 
+ * @param ctrl ponteiro para a struct controle_t (após o fim das aeronaves)
+ */
+void controle_relatorio_esperas(const controle_t* ctrl);
+
+/**
+ * @brief Pede o encerramento da thread do banqueiro
+ * 
+ * Deve ser chamado depois que todas as aeronaves terminaram; o banqueiro ainda
+ * consome as mensagens pendentes antes de sair.
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ */
+void controle_encerrar(controle_t* ctrl);
+
+/**
+ * @brief Ponto de parada da aeronave no início de cada salto
+ * 
+ * Retorna imediatamente se não há checkpoint pendente; caso contrário, conta a aeronave como
+ * estacionada, acorda o banqueiro e bloqueia até o instantâneo ser gravado.
+ * 
+ * @param ctrl ponteiro para a struct controle_t
+ */
+void controle_ponto_seguro(controle_t* ctrl);
+
+/**
+ * @brief Imprime o número de checkpoints gravados e os tempos médios de pausa e gravação
  * 
  * @param ctrl ponteiro para a struct controle_t
- * @return true 
- * @return false 
  */
-bool existe_aerothread_alive(controle_t* ctrl);
+void controle_relatorio_checkpoints(const controle_t* ctrl);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,314 @@
+#define _POSIX_C_SOURCE 200112L // importante para pthread_condattr_setclock e clock_gettime
+#include "escala.h"
+#include "banqueiro.h"
+#include "rota.h"
+#include "utils.h"
+#include "perfil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NS_POR_MS 1000000LL
+#define NS_POR_S  1000000000LL
+
+// Chave da ordem de concessão da simulação (a prioridade vai junto: o comparador não depende de
+// estado global, e várias escalas podem ser compiladas ao mesmo tempo na varredura)
+typedef struct ordem_chave {
+    unsigned int prioridade;
+    int aero_idx;
+} ordem_chave_t;
+
+// Maior prioridade primeiro, empate pelo índice
+static int comparar_prioridade(const void* a, const void* b) {
+    const ordem_chave_t* x = (const ordem_chave_t*)a;
+    const ordem_chave_t* y = (const ordem_chave_t*)b;
+    if (x->prioridade != y->prioridade) return x->prioridade > y->prioridade ? -1 : 1;
+    return x->aero_idx - y->aero_idx;
+}
+
+static void emitir_bilhete(escala_t* escala, int aero_idx, int salto, int setor_idx, long long instante_ms) {
+    bilhete_t* bilhete = &escala->bilhetes[escala->num_bilhetes];
+    bilhete->aero_index = aero_idx;
+    bilhete->salto = salto;
+    bilhete->setor_index = setor_idx;
+    bilhete->instante_ms = instante_ms;
+
+    escala->indice_bilhete[escala->indice_inicio[aero_idx] + (size_t)salto] = escala->num_bilhetes;
+    escala->num_bilhetes++;
+}
+
+// Simulação em eventos discretos: cada voo dura exatamente permanencia_ms
+static bool simular(escala_t* escala, const aeronave_t* aeronaves, size_t n, size_t num_setores, const int* capacidades, long long permanencia_ms) {
+    size_t total = escala->indice_inicio[n];
+
+    banqueiro_t* b = banqueiro_criar(n, num_setores);
+    int* caminho = (int*)malloc((total + 1) * sizeof(int));
+    int* ordem = (int*)malloc((n + 1) * sizeof(int));
+    int* salto = (int*)calloc(n + 1, sizeof(int));
+    long long* fim_voo = (long long*)calloc(n + 1, sizeof(long long));
+    long long* inicio_espera = (long long*)calloc(n + 1, sizeof(long long));
+    bool* concluida = (bool*)calloc(n + 1, sizeof(bool));
+    ordem_chave_t* chaves = (ordem_chave_t*)malloc((n + 1) * sizeof(ordem_chave_t));
+    bool ok = b != NULL && caminho != NULL && ordem != NULL && salto != NULL && fim_voo != NULL && inicio_espera != NULL && concluida != NULL &&
+              chaves != NULL;
+
+    if (ok) {
+        for (size_t j = 0; j < num_setores; j++) {
+            banqueiro_definir_disponivel(b, (int)j, capacidades[j]);
+        }
+        for (size_t p = 0; p < n; p++) {
+            size_t h = escala->indice_inicio[p];
+            for (rota_node_t* curr = aeronaves[p].rota.head; curr != NULL; curr = curr->next) {
+                caminho[h++] = curr->setor->setor_index;
+                banqueiro_definir_max(b, (int)p, curr->setor->setor_index, 1);
+            }
+            chaves[p].prioridade = aeronaves[p].prioridade;
+            chaves[p].aero_idx = (int)p;
+            fim_voo[p] = 0; // todas "pousam" no instante 0: começam aguardando o primeiro setor
+        }
+        qsort(chaves, n, sizeof(ordem_chave_t), comparar_prioridade);
+        for (size_t k = 0; k < n; k++) {
+            ordem[k] = chaves[k].aero_idx;
+        }
+    }
+
+    long long t = 0;
+    size_t concluidas = 0;
+    while (ok && concluidas < n) {
+        // Fim dos voos: a aeronave passa a aguardar o próximo setor ou deixa o último
+        for (size_t p = 0; p < n; p++) {
+            if (concluida[p] || fim_voo[p] < 0 || fim_voo[p] > t) continue;
+
+            fim_voo[p] = -1;
+            if ((size_t)salto[p] == aeronaves[p].rota.len) {
+                if (salto[p] > 0) {
+                    banqueiro_liberar(b, (int)p, caminho[escala->indice_inicio[p] + (size_t)salto[p] - 1], 1);
+                }
+                emitir_bilhete(escala, (int)p, salto[p], -1, t);
+                concluida[p] = true;
+                concluidas++;
+            } else {
+                inicio_espera[p] = t;
+            }
+        }
+
+        // Concessões na ordem de prioridade até não haver mais nenhuma segura neste instante
+        bool progresso = true;
+        while (progresso) {
+            progresso = false;
+            for (size_t k = 0; k < n; k++) {
+                int p = ordem[k];
+                if (concluida[p] || fim_voo[p] >= 0) continue;
+
+                size_t base = escala->indice_inicio[p];
+                banqueiro_pedido_t pedido = {
+                    .processo = p,
+                    .recurso = caminho[base + (size_t)salto[p]],
+                    .quantidade = 1,
+                    .recurso_liberado = salto[p] > 0 ? caminho[base + (size_t)salto[p] - 1] : -1,
+                };
+                if (!banqueiro_conceder(b, &pedido)) continue;
+
+                emitir_bilhete(escala, p, salto[p], pedido.recurso, t);
+                escala->espera_planejada_ms += t - inicio_espera[p];
+                escala->saltos_planejados++;
+                salto[p]++;
+                fim_voo[p] = t + permanencia_ms;
+                progresso = true;
+            }
+        }
+
+        // Avança até o próximo fim de voo
+        long long proximo = -1;
+        for (size_t p = 0; p < n; p++) {
+            if (!concluida[p] && fim_voo[p] >= 0 && (proximo < 0 || fim_voo[p] < proximo)) {
+                proximo = fim_voo[p];
+            }
+        }
+        if (proximo < 0 && concluidas < n) {
+            fprintf(stderr, "ERRO: a compilação da escala chegou a um impasse no instante %lld ms\n", t);
+            ok = false;
+        }
+        t = proximo;
+    }
+
+    if (ok) {
+        escala->makespan_planejado_ms = escala->num_bilhetes > 0 ? escala->bilhetes[escala->num_bilhetes - 1].instante_ms : 0;
+    }
+
+    banqueiro_destruir(b);
+    free(caminho);
+    free(ordem);
+    free(salto);
+    free(fim_voo);
+    free(inicio_espera);
+    free(concluida);
+    free(chaves);
+    return ok;
+}
+
+bool escala_compilar(escala_t* escala, const aeronave_t* aeronaves, size_t num_aeronaves, size_t num_setores, const int* capacidades, long long permanencia_ms, long long tolerancia_ms) {
+    memset(escala, 0, sizeof(*escala));
+    escala->tolerancia_ns = tolerancia_ms * NS_POR_MS;
+    escala->permanencia_ns = permanencia_ms * NS_POR_MS;
+
+    // Cada aeronave tem rota.len entradas e uma saída final
+    escala->indice_inicio = (size_t*)malloc((num_aeronaves + 1) * sizeof(size_t));
+    if (escala->indice_inicio == NULL) return false;
+    escala->indice_inicio[0] = 0;
+    for (size_t p = 0; p < num_aeronaves; p++) {
+        escala->indice_inicio[p + 1] = escala->indice_inicio[p] + aeronaves[p].rota.len + 1;
+    }
+
+    size_t total = escala->indice_inicio[num_aeronaves];
+    escala->bilhetes = (bilhete_t*)malloc((total + 1) * sizeof(bilhete_t));
+    escala->indice_bilhete = (size_t*)malloc((total + 1) * sizeof(size_t));
+    escala->bilhete_anterior_ns = (long long*)calloc(num_aeronaves + 1, sizeof(long long));
+    if (escala->bilhetes == NULL || escala->indice_bilhete == NULL || escala->bilhete_anterior_ns == NULL ||
+        !simular(escala, aeronaves, num_aeronaves, num_setores, capacidades, permanencia_ms)) {
+        free(escala->bilhetes);
+        free(escala->indice_bilhete);
+        free(escala->indice_inicio);
+        free(escala->bilhete_anterior_ns);
+        memset(escala, 0, sizeof(*escala));
+        return false;
+    }
+
+    // A espera usa CLOCK_MONOTONIC, mesma base de tempo_monotonico_ns()
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&escala->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&escala->lock, NULL);
+
+    return true;
+}
+
+void escala_destroy(escala_t* escala) {
+    free(escala->bilhetes);
+    free(escala->indice_bilhete);
+    free(escala->indice_inicio);
+    free(escala->bilhete_anterior_ns);
+    pthread_mutex_destroy(&escala->lock);
+    pthread_cond_destroy(&escala->cond);
+}
+
+void escala_iniciar(escala_t* escala) {
+    long long adquirido_ns = perfil_lock(&escala->lock, PERFIL_LOCK_ESCALA);
+    escala->proximo = 0;
+    escala->abandonada = false;
+    escala->ultimo_avanco_ns = tempo_monotonico_ns();
+    perfil_unlock(&escala->lock, PERFIL_LOCK_ESCALA, adquirido_ns);
+}
+
+// Instante em que a aeronave do bilhete corrente deveria estar pronta para executá-lo: o primeiro
+// salto não tem voo antes; os demais vêm depois da permanência planejada no setor do bilhete
+// anterior dela. Pronta antes de o bilhete virar o corrente, só falta a aeronave perceber a vez.
+static long long pronta_planejada_ns(const escala_t* escala, size_t atual) {
+    const bilhete_t* b = &escala->bilhetes[atual];
+    long long pronta_ns = escala->ultimo_avanco_ns;
+    if (b->salto > 0) {
+        long long fim_voo_ns = escala->bilhete_anterior_ns[b->aero_index] + escala->permanencia_ns;
+        if (fim_voo_ns > pronta_ns) pronta_ns = fim_voo_ns;
+    }
+    return pronta_ns;
+}
+
+// Aguarda (com escala->lock, adquirido em *adquirido_ns) até o bilhete ser o próximo. Abandona a
+// escala se a aeronave do bilhete corrente atrasar mais que a tolerância além do instante em que
+// deveria estar pronta (o atraso de uma não se soma ao das outras: cada uma mede o próprio voo).
+static bool aguardar_bilhete(escala_t* escala, size_t bilhete, long long* adquirido_ns) {
+    while (!escala->abandonada && escala->proximo != bilhete) {
+        size_t atual = escala->proximo;
+        long long prazo_ns = pronta_planejada_ns(escala, atual) + escala->tolerancia_ns;
+
+        if (tempo_monotonico_ns() >= prazo_ns) {
+            printf_timestamped("[ESCALA] Bilhete %zu (aeronave %d) atrasado: abandonando a escala.\n", atual, escala->bilhetes[atual].aero_index);
+            escala->abandonada = true;
+            pthread_cond_broadcast(&escala->cond);
+            break;
+        }
+
+        struct timespec ts = { .tv_sec = prazo_ns / NS_POR_S, .tv_nsec = prazo_ns % NS_POR_S };
+        perfil_cond_timedwait(&escala->cond, &escala->lock, PERFIL_LOCK_ESCALA, &ts, adquirido_ns);
+    }
+
+    return !escala->abandonada;
+}
+
+// Marca o bilhete corrente como executado (com escala->lock)
+static void avancar(escala_t* escala) {
+    long long agora_ns = tempo_monotonico_ns();
+    escala->bilhete_anterior_ns[escala->bilhetes[escala->proximo].aero_index] = agora_ns;
+    escala->proximo++;
+    escala->ultimo_avanco_ns = agora_ns;
+    pthread_cond_broadcast(&escala->cond);
+}
+
+static void registrar_espera(aeronave_t* aeronave, long long espera_ns) {
+    aeronave_estado_t* estado = aeronave->estado;
+
+    long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
+    estado->espera_total_ns += espera_ns;
+    if (espera_ns > estado->espera_max_ns) {
+        estado->espera_max_ns = espera_ns;
+    }
+    perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
+}
+
+bool escala_entrar(escala_t* escala, setor_t* setor, aeronave_t* aeronave, int salto, long long inicio_ns) {
+    size_t bilhete = escala->indice_bilhete[escala->indice_inicio[aeronave->aero_index] + (size_t)salto];
+
+    long long adquirido_ns = perfil_lock(&escala->lock, PERFIL_LOCK_ESCALA);
+    bool na_vez = aguardar_bilhete(escala, bilhete, &adquirido_ns);
+    if (na_vez) {
+        // A mensagem é postada antes de liberar o próximo bilhete: o banqueiro aplica as
+        // entradas na ordem da escala, e antes de qualquer pedido online feito após um abandono
+        mensagem_t* msg = &aeronave->estado->msg_solicitacao;
+        caixa_postal_reservar(msg);
+        msg->tipo = MSG_ENTRADA_ESCALA;
+        msg->aero_index = aeronave->aero_index;
+        msg->setor_index = setor->setor_index;
+        caixa_postal_enviar(&setor->controle->caixa, msg);
+        avancar(escala);
+    }
+    perfil_unlock(&escala->lock, PERFIL_LOCK_ESCALA, adquirido_ns);
+
+    // No abandono a espera continua no controle online, que a registra desde inicio_ns
+    if (na_vez) {
+        registrar_espera(aeronave, tempo_monotonico_ns() - inicio_ns);
+    }
+    return na_vez;
+}
+
+bool escala_sair(escala_t* escala, setor_t* setor, aeronave_t* aeronave) {
+    size_t bilhete = escala->indice_bilhete[escala->indice_inicio[aeronave->aero_index] + aeronave->rota.len];
+
+    long long adquirido_ns = perfil_lock(&escala->lock, PERFIL_LOCK_ESCALA);
+    bool na_vez = aguardar_bilhete(escala, bilhete, &adquirido_ns);
+    if (na_vez) {
+        if (setor != NULL) {
+            setor_liberar_saida(setor, aeronave);
+        }
+        avancar(escala);
+    }
+    perfil_unlock(&escala->lock, PERFIL_LOCK_ESCALA, adquirido_ns);
+
+    return na_vez;
+}
+
+void escala_relatorio(escala_t* escala) {
+    long long adquirido_ns = perfil_lock(&escala->lock, PERFIL_LOCK_ESCALA);
+    size_t seguidos = escala->proximo;
+    bool abandonada = escala->abandonada;
+    perfil_unlock(&escala->lock, PERFIL_LOCK_ESCALA, adquirido_ns);
+
+    printf("Escala: makespan planejado %.2f s | espera planejada %.2f ms por setor | %zu de %zu bilhetes seguidos%s\n",
+           (double)escala->makespan_planejado_ms / 1000.0,
+           escala->saltos_planejados > 0 ? (double)escala->espera_planejada_ms / (double)escala->saltos_planejados : 0.0,
+           seguidos, escala->num_bilhetes,
+           abandonada ? " (abandonada: controle online)" : "");
+}
@@ -0,0 +1,138 @@
+#ifndef ESCALA_H
+#define ESCALA_H
+
+#include "controle.h"
+#include "aeronave.h"
+#include "setor.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Entrada da escala: a aeronave entra no setor do salto `salto` da rota
+ * (salto == rota.len indica a saída do último setor)
+ * 
+ * @param aero_index aeronave
+ * @param salto posição na rota
+ * @param setor_index setor de destino (-1 na saída final)
+ * @param instante_ms instante planejado, a partir do início da execução
+ */
+typedef struct bilhete {
+    int aero_index;
+    int salto;
+    int setor_index;
+    long long instante_ms;
+} bilhete_t;
+
+/**
+ * @brief Escala compilada antes do início das threads (modo em lote)
+ * 
+ * A compilação simula o banqueiro em eventos discretos (libbanqueiro) com a permanência
+ * média de usar_setor() em cada setor, concedendo na ordem de prioridade. O resultado é uma
+ * ordem global de bilhetes (entradas e saídas finais) em que cada entrada foi segura no
+ * estado produzido pelos bilhetes anteriores. Em execução, seguir os bilhetes estritamente
+ * em ordem reproduz a mesma sequência de estados do banqueiro, logo dispensa a checagem de
+ * segurança: a aeronave só confere se o bilhete corrente é o seu.
+ * 
+ * Se a duração real dos voos desviar e o bilhete corrente atrasar mais que a tolerância, a escala
+ * é abandonada e todas as aeronaves passam ao controle online do banqueiro, que continua de um
+ * estado seguro (o dos bilhetes executados). O atraso é medido contra o instante em que a própria
+ * aeronave deveria estar pronta: o bilhete anterior dela mais a permanência planejada (ou, se ela
+ * ficou pronta antes, o instante em que o bilhete passou a ser o corrente).
+ * 
+ * @param bilhetes ordem global planejada
+ * @param num_bilhetes 
+ * @param indice_inicio posição, em indice_bilhete, do primeiro salto de cada aeronave
+ * @param indice_bilhete bilhete de cada (aeronave, salto), saltos 0..rota.len
+ * @param makespan_planejado_ms instante planejado da última saída
+ * @param espera_planejada_ms soma das esperas planejadas por setor
+ * @param saltos_planejados total de entradas
+ * @param lock protege os campos de execução abaixo
+ * @param cond sinalizada a cada bilhete executado (ou no abandono)
+ * @param proximo próximo bilhete a executar
+ * @param ultimo_avanco_ns instante em que o bilhete corrente passou a ser o próximo
+ * @param bilhete_anterior_ns instante do último bilhete executado de cada aeronave
+ * @param permanencia_ns permanência planejada em cada setor
+ * @param tolerancia_ns atraso admitido além do instante em que a aeronave deveria estar pronta
+ * @param abandonada a escala foi abandonada (controle online)
+ */
+typedef struct escala {
+    bilhete_t* bilhetes;
+    size_t num_bilhetes;
+    size_t* indice_inicio;
+    size_t* indice_bilhete;
+    long long makespan_planejado_ms;
+    long long espera_planejada_ms;
+    size_t saltos_planejados;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t proximo;
+    long long ultimo_avanco_ns;
+    long long* bilhete_anterior_ns;
+    long long permanencia_ns;
+    long long tolerancia_ns;
+    bool abandonada;
+} escala_t;
+
+/**
+ * @brief Compila a escala da frota (rotas e demandas já definidas)
+ * 
+ * @param escala saída
+ * @param aeronaves frota
+ * @param num_aeronaves 
+ * @param num_setores 
+ * @param capacidades aeronaves simultâneas admitidas em cada setor (num_setores valores)
+ * @param permanencia_ms permanência estimada em cada setor
+ * @param tolerancia_ms atraso admitido antes do abandono da escala
+ * @return true em sucesso; false se faltar memória ou a simulação chegar a um impasse
+ */
+bool escala_compilar(escala_t* escala, const aeronave_t* aeronaves, size_t num_aeronaves, size_t num_setores, const int* capacidades, long long permanencia_ms, long long tolerancia_ms);
+
+/**
+ * @brief Libera a memória da escala
+ * 
+ * @param escala 
+ */
+void escala_destroy(escala_t* escala);
+
+/**
+ * @brief Marca o início da execução (referência para os atrasos)
+ * 
+ * @param escala 
+ */
+void escala_iniciar(escala_t* escala);
+
+/**
+ * @brief Aguarda o bilhete da aeronave para entrar no setor e, na sua vez, comunica a entrada ao
+ * controle (MSG_ENTRADA_ESCALA). Na vez do bilhete a espera é somada à espera da aeronave; no
+ * abandono não é registrada (ver setor_solicitar_entrada_desde).
+ * 
+ * @param escala 
+ * @param setor setor de destino
+ * @param aeronave 
+ * @param salto posição do setor na rota
+ * @param inicio_ns início da espera do salto (tempo_monotonico_ns)
+ * @return true se entrou pela escala; false se a escala foi abandonada (usar o controle online)
+ */
+bool escala_entrar(escala_t* escala, setor_t* setor, aeronave_t* aeronave, int salto, long long inicio_ns);
+
+/**
+ * @brief Aguarda o bilhete da saída final e libera o último setor
+ * 
+ * @param escala 
+ * @param setor último setor da rota
+ * @param aeronave 
+ * @return true se saiu pela escala; false se a escala foi abandonada (liberar normalmente)
+ */
+bool escala_sair(escala_t* escala, setor_t* setor, aeronave_t* aeronave);
+
+/**
+ * @brief Imprime o planejado (makespan, espera média) e quantos bilhetes foram seguidos
+ * 
+ * @param escala 
+ */
+void escala_relatorio(escala_t* escala);
+
+#endif
@@ -0,0 +1,344 @@
+#define _POSIX_C_SOURCE 200112L // importante para pthread_condattr_setclock
+#include "invariantes.h"
+#include "controle.h"
+#include "aeronave.h"
+#include "setor.h"
+#include "banqueiro.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+// Setores com fila listados no diagnóstico de impasse
+#define IMPASSE_MAX_SETORES 10
+
+void invariantes_violacao(invariantes_t* inv, const char* formato, ...) {
+    size_t k = atomic_fetch_add(&inv->violacoes, 1);
+    if (k >= INVARIANTES_MAX_RELATADAS) return;
+
+    va_list args;
+    va_start(args, formato);
+    fprintf(stderr, "[INVARIANTE] ");
+    vfprintf(stderr, formato, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+
+    if (k == INVARIANTES_MAX_RELATADAS - 1) {
+        fprintf(stderr, "[INVARIANTE] Demais violações apenas contadas.\n");
+    }
+}
+
+// Estado das filas no momento do impasse. O banqueiro pode estar preso com o lock: sem ele,
+// o diagnóstico é omitido em vez de travar o vigia também
+static void imprimir_impasse(invariantes_t* inv) {
+    controle_t* ctrl = inv->ctrl;
+    if (pthread_mutex_trylock(&ctrl->banker_lock) != 0) {
+        fprintf(stderr, "[VIGIA] banker_lock ocupado: o banqueiro não concluiu a passada.\n");
+        return;
+    }
+
+    size_t listados = 0;
+    for (size_t j = 0; j < ctrl->num_setores && listados < IMPASSE_MAX_SETORES; j++) {
+        const setor_t* setor = &ctrl->setores[j];
+        if (setor->fila_len == 0) continue;
+
+        int a = setor->fila_inicio;
+        fprintf(stderr, "[VIGIA] Setor %s: disponível %d de %d, fila %zu, primeira %s (ocupa %d, necessidade %d)\n",
+                setor->id, banqueiro_disponivel(ctrl->banqueiro, (int)j), ctrl->capacidade[j], setor->fila_len,
+                ctrl->aeronaves[a].id, ctrl->setor_ocupado[a], banqueiro_necessidade(ctrl->banqueiro, a, (int)j));
+        listados++;
+    }
+    pthread_mutex_unlock(&ctrl->banker_lock);
+}
+
+// Acorda a cada quarto do prazo e compara o contador de concessões com o último visto
+static void* vigia_thread(void* arg) {
+    invariantes_t* inv = (invariantes_t*)arg;
+    long long passo_ns = inv->prazo_progresso_ns / 4;
+    size_t ultimo = atomic_load(&inv->concessoes);
+    long long ultimo_progresso_ns = tempo_monotonico_ns();
+
+    pthread_mutex_lock(&inv->vigia_lock);
+    while (!atomic_load(&inv->encerrar)) {
+        long long limite_ns = tempo_monotonico_ns() + passo_ns;
+        struct timespec ts = { .tv_sec = limite_ns / 1000000000LL, .tv_nsec = limite_ns % 1000000000LL };
+        pthread_cond_timedwait(&inv->vigia_cond, &inv->vigia_lock, &ts);
+
+        long long agora = tempo_monotonico_ns();
+        size_t concessoes = atomic_load(&inv->concessoes);
+        size_t em_fila = atomic_load(&inv->em_fila);
+        if (concessoes != ultimo || em_fila == 0) {
+            ultimo = concessoes;
+            ultimo_progresso_ns = agora;
+            continue;
+        }
+        if (agora - ultimo_progresso_ns < inv->prazo_progresso_ns) continue;
+
+        invariantes_violacao(inv, "impasse: nenhuma concessão em %.1f s com %zu aeronave(s) nas filas (%zu concessões até aqui)",
+                             (double)(agora - ultimo_progresso_ns) / 1e9, em_fila, concessoes);
+        imprimir_impasse(inv);
+        fflush(stdout);
+        fflush(stderr);
+        _exit(2);
+    }
+    pthread_mutex_unlock(&inv->vigia_lock);
+
+    return NULL;
+}
+
+bool invariantes_init(invariantes_t* inv, controle_t* ctrl, unsigned int prazo_progresso_s) {
+    inv->ctrl = ctrl;
+    atomic_init(&inv->violacoes, 0);
+    atomic_init(&inv->concessoes, 0);
+    atomic_init(&inv->em_fila, 0);
+    atomic_init(&inv->encerrar, false);
+    inv->varreduras = 0;
+    inv->varredura_total_ns = 0;
+    inv->inicio_ns = tempo_monotonico_ns();
+    inv->fim_ns = inv->inicio_ns;
+    inv->proxima_varredura_ns = inv->inicio_ns + INVARIANTES_INTERVALO_MS * 1000000LL;
+    inv->prazo_progresso_ns = (long long)prazo_progresso_s * 1000000000LL;
+
+    inv->concedido_desde_ns = (long long*)calloc(ctrl->num_aeronaves, sizeof(long long));
+    inv->ocupantes = (int*)calloc(ctrl->num_setores, sizeof(int));
+    if (inv->concedido_desde_ns == NULL || inv->ocupantes == NULL) return false;
+
+    pthread_mutex_init(&inv->vigia_lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&inv->vigia_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (inv->prazo_progresso_ns > 0 && pthread_create(&inv->vigia, NULL, vigia_thread, inv) != 0) {
+        return false;
+    }
+    return true;
+}
+
+void invariantes_concessao(invariantes_t* inv, int aero_idx, int setor_idx) {
+    controle_t* ctrl = inv->ctrl;
+    atomic_fetch_add_explicit(&inv->concessoes, 1, memory_order_relaxed);
+
+    int disponivel = banqueiro_disponivel(ctrl->banqueiro, setor_idx);
+    if (disponivel < 0) {
+        invariantes_violacao(inv, "setor %s com disponível %d após a concessão à aeronave %s",
+                             ctrl->setores[setor_idx].id, disponivel, ctrl->aeronaves[aero_idx].id);
+    }
+    if (banqueiro_alocado(ctrl->banqueiro, aero_idx, setor_idx) > banqueiro_max(ctrl->banqueiro, aero_idx, setor_idx)) {
+        invariantes_violacao(inv, "aeronave %s alocou além da demanda máxima no setor %s",
+                             ctrl->aeronaves[aero_idx].id, ctrl->setores[setor_idx].id);
+    }
+    if (ctrl->fila_nos[aero_idx].setor_index != -1) {
+        invariantes_violacao(inv, "aeronave %s continua na fila do setor %d após a concessão do setor %s",
+                             ctrl->aeronaves[aero_idx].id, ctrl->fila_nos[aero_idx].setor_index, ctrl->setores[setor_idx].id);
+    }
+}
+
+void invariantes_liberacao(invariantes_t* inv, int aero_idx, int setor_idx) {
+    controle_t* ctrl = inv->ctrl;
+
+    int disponivel = banqueiro_disponivel(ctrl->banqueiro, setor_idx);
+    if (disponivel > ctrl->capacidade[setor_idx]) {
+        invariantes_violacao(inv, "setor %s com disponível %d acima da capacidade %d após a liberação pela aeronave %s",
+                             ctrl->setores[setor_idx].id, disponivel, ctrl->capacidade[setor_idx], ctrl->aeronaves[aero_idx].id);
+    }
+}
+
+// Matrizes do banqueiro: disponível + Σ alocado conservado e alocação dentro da demanda máxima
+static void verificar_banqueiro(invariantes_t* inv) {
+    controle_t* ctrl = inv->ctrl;
+    banqueiro_t* b = ctrl->banqueiro;
+
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        int soma = 0;
+        for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+            int alocado = banqueiro_alocado(b, (int)p, (int)j);
+            soma += alocado;
+            if (alocado < 0 || alocado > banqueiro_max(b, (int)p, (int)j)) {
+                invariantes_violacao(inv, "aeronave %s com alocação %d fora de [0, max] no setor %s",
+                                     ctrl->aeronaves[p].id, alocado, ctrl->setores[j].id);
+            }
+        }
+
+        int disponivel = banqueiro_disponivel(b, (int)j);
+        if (disponivel < 0 || disponivel + soma != ctrl->capacidade[j]) {
+            invariantes_violacao(inv, "setor %s: disponível %d + alocado %d != capacidade %d",
+                                 ctrl->setores[j].id, disponivel, soma, ctrl->capacidade[j]);
+        }
+    }
+
+    if (!banqueiro_estado_seguro(b)) {
+        invariantes_violacao(inv, "estado do banqueiro inseguro");
+    }
+}
+
+// Ocupantes de cada setor segundo o controle, limitados pela capacidade
+static void verificar_ocupacao(invariantes_t* inv) {
+    controle_t* ctrl = inv->ctrl;
+
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        inv->ocupantes[j] = 0;
+    }
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        int j = ctrl->setor_ocupado[p];
+        if (j >= 0) inv->ocupantes[j]++;
+    }
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        if (inv->ocupantes[j] > ctrl->capacidade[j]) {
+            invariantes_violacao(inv, "setor %s com %d ocupantes para capacidade %d",
+                                 ctrl->setores[j].id, inv->ocupantes[j], ctrl->capacidade[j]);
+        }
+    }
+}
+
+// Encadeamento duplo, tamanho e ordem (chave não crescente) de cada fila; nenhum nó fora delas
+static void verificar_filas(invariantes_t* inv) {
+    controle_t* ctrl = inv->ctrl;
+    const fila_no_t* nos = ctrl->fila_nos;
+    size_t na_fila = 0;
+
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        const setor_t* setor = &ctrl->setores[j];
+        size_t len = 0;
+        int anterior = -1;
+
+        for (int a = setor->fila_inicio; a != -1; anterior = a, a = nos[a].prox) {
+            // Um ciclo no encadeamento faria o percurso não terminar
+            if (++len > ctrl->num_aeronaves) {
+                invariantes_violacao(inv, "fila do setor %s com ciclo", setor->id);
+                break;
+            }
+            if (nos[a].setor_index != (int)j || nos[a].ant != anterior) {
+                invariantes_violacao(inv, "nó da aeronave %s mal encadeado na fila do setor %s", ctrl->aeronaves[a].id, setor->id);
+            }
+            if (anterior != -1 && nos[anterior].chave < nos[a].chave) {
+                invariantes_violacao(inv, "fila do setor %s fora da ordem da política na aeronave %s", setor->id, ctrl->aeronaves[a].id);
+            }
+        }
+        if (len != setor->fila_len || setor->fila_fim != anterior) {
+            invariantes_violacao(inv, "fila do setor %s com %zu nós para fila_len %zu", setor->id, len, setor->fila_len);
+        }
+        na_fila += setor->fila_len;
+    }
+
+    size_t marcados = 0;
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        if (nos[p].setor_index != -1) marcados++;
+    }
+    if (marcados != na_fila) {
+        invariantes_violacao(inv, "%zu nós marcados em filas para %zu aeronaves encadeadas", marcados, na_fila);
+    }
+}
+
+// Concessões: nenhuma aeronave na fila com concessão pendente, e nenhuma concessão sem consumo além do prazo
+static void verificar_concessoes(invariantes_t* inv, long long agora) {
+    controle_t* ctrl = inv->ctrl;
+
+    for (size_t p = 0; p < ctrl->num_aeronaves; p++) {
+        aeronave_estado_t* estado = &ctrl->estados[p];
+        pthread_mutex_lock(&estado->lock);
+        int concedido = estado->setor_concedido;
+        pthread_mutex_unlock(&estado->lock);
+
+        if (concedido == -1) {
+            inv->concedido_desde_ns[p] = 0;
+            continue;
+        }
+        if (ctrl->fila_nos[p].setor_index != -1) {
+            invariantes_violacao(inv, "aeronave %s na fila do setor %d com a concessão do setor %d pendente",
+                                 ctrl->aeronaves[p].id, ctrl->fila_nos[p].setor_index, concedido);
+        }
+
+        if (inv->concedido_desde_ns[p] == 0) {
+            inv->concedido_desde_ns[p] = agora;
+        } else if (inv->prazo_progresso_ns > 0 && agora - inv->concedido_desde_ns[p] > inv->prazo_progresso_ns) {
+            invariantes_violacao(inv, "aeronave %s não consumiu a concessão do setor %d em %.1f s",
+                                 ctrl->aeronaves[p].id, concedido, (double)(agora - inv->concedido_desde_ns[p]) / 1e9);
+            inv->concedido_desde_ns[p] = agora; // relata de novo só depois de outro prazo
+        }
+    }
+}
+
+static void varrer(invariantes_t* inv, long long agora) {
+    verificar_banqueiro(inv);
+    verificar_ocupacao(inv);
+    verificar_filas(inv);
+    verificar_concessoes(inv, agora);
+}
+
+void invariantes_passada(invariantes_t* inv) {
+    controle_t* ctrl = inv->ctrl;
+
+    size_t em_fila = 0;
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        em_fila += ctrl->setores[j].fila_len;
+    }
+    atomic_store_explicit(&inv->em_fila, em_fila, memory_order_relaxed);
+
+    long long agora = tempo_monotonico_ns();
+    if (agora < inv->proxima_varredura_ns) return;
+
+    varrer(inv, agora);
+
+    long long fim = tempo_monotonico_ns();
+    long long custo = fim - agora;
+    inv->varreduras++;
+    inv->varredura_total_ns += custo;
+
+    // Frotas grandes tornam a varredura cara: o intervalo cresce com ela
+    long long intervalo = INVARIANTES_INTERVALO_MS * 1000000LL;
+    if (custo * INVARIANTES_FATOR_CUSTO > intervalo) intervalo = custo * INVARIANTES_FATOR_CUSTO;
+    inv->proxima_varredura_ns = fim + intervalo;
+}
+
+void invariantes_encerrar(invariantes_t* inv) {
+    inv->fim_ns = tempo_monotonico_ns();
+
+    if (inv->prazo_progresso_ns > 0) {
+        pthread_mutex_lock(&inv->vigia_lock);
+        atomic_store(&inv->encerrar, true);
+        pthread_cond_signal(&inv->vigia_cond);
+        pthread_mutex_unlock(&inv->vigia_lock);
+        pthread_join(inv->vigia, NULL);
+    }
+
+    // A thread do banqueiro já terminou: o estado é lido sem o lock
+    controle_t* ctrl = inv->ctrl;
+    varrer(inv, inv->fim_ns);
+    for (size_t j = 0; j < ctrl->num_setores; j++) {
+        int disponivel = banqueiro_disponivel(ctrl->banqueiro, (int)j);
+        if (disponivel != ctrl->capacidade[j] || ctrl->setores[j].fila_len != 0) {
+            invariantes_violacao(inv, "ao final, setor %s com disponível %d de %d e %zu aeronave(s) na fila",
+                                 ctrl->setores[j].id, disponivel, ctrl->capacidade[j], ctrl->setores[j].fila_len);
+        }
+    }
+}
+
+size_t invariantes_relatorio(const invariantes_t* inv) {
+    size_t concessoes = atomic_load(&inv->concessoes);
+    size_t violacoes = atomic_load(&inv->violacoes);
+    double duracao_s = (double)(inv->fim_ns - inv->inicio_ns) / 1e9;
+
+    printf("Soak: %zu concessões em %.2f s (%.0f concessões/s)\n", concessoes, duracao_s,
+           duracao_s > 0.0 ? (double)concessoes / duracao_s : 0.0);
+    printf("Varreduras de invariantes: %zu", inv->varreduras);
+    if (inv->varreduras > 0) {
+        printf(" | custo médio: %.3f ms | %.2f%% do tempo", (double)inv->varredura_total_ns / (double)inv->varreduras / 1e6,
+               duracao_s > 0.0 ? 100.0 * (double)inv->varredura_total_ns / 1e9 / duracao_s : 0.0);
+    }
+    printf("\n");
+    printf("Violações de invariantes: %zu\n", violacoes);
+
+    return violacoes;
+}
+
+void invariantes_destroy(invariantes_t* inv) {
+    free(inv->concedido_desde_ns);
+    free(inv->ocupantes);
+    pthread_mutex_destroy(&inv->vigia_lock);
+    pthread_cond_destroy(&inv->vigia_cond);
+}
@@ -0,0 +1,142 @@
+#ifndef INVARIANTES_H
+#define INVARIANTES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+typedef struct controle controle_t;
+
+// Violações impressas em stderr (as seguintes são apenas contadas)
+#define INVARIANTES_MAX_RELATADAS 20
+
+// Intervalo mínimo entre varreduras completas do estado
+#define INVARIANTES_INTERVALO_MS 100
+
+// A próxima varredura espera pelo menos este múltiplo do custo da anterior (custo <= ~2% do banqueiro)
+#define INVARIANTES_FATOR_CUSTO 50
+
+/**
+ * @brief Verificação online das invariantes do controle (modo soak)
+ *
+ * Três níveis de custo:
+ * - a cada concessão e liberação, checagens O(1) no setor envolvido;
+ * - a cada passada do banqueiro, a soma das filas (O(m)) publicada para o vigia;
+ * - periodicamente, sob banker_lock, uma varredura completa: disponível + Σ alocado igual à
+ *   capacidade, ocupantes por setor dentro da capacidade, encadeamento e ordem das filas,
+ *   nenhuma aeronave na fila com concessão pendente, nenhuma concessão esquecida por mais
+ *   que o prazo de progresso e a segurança do estado inteiro.
+ *
+ * O vigia é uma thread própria que declara impasse quando nenhuma concessão acontece durante
+ * o prazo de progresso com aeronaves nas filas: imprime o estado e encerra o processo com o
+ * código 2, em vez de deixar a execução travada.
+ *
+ * @param ctrl controle verificado
+ * @param violacoes violações encontradas (controle e vigia)
+ * @param concessoes concessões feitas pelo banqueiro (progresso observado pelo vigia)
+ * @param em_fila aeronaves nas filas ao fim da última passada
+ * @param varreduras varreduras completas executadas
+ * @param varredura_total_ns tempo somado das varreduras (sob banker_lock)
+ * @param proxima_varredura_ns
+ * @param concedido_desde_ns por aeronave, instante em que a concessão pendente foi vista (0 = nenhuma)
+ * @param ocupantes área de trabalho da varredura (aeronaves ocupando cada setor)
+ * @param prazo_progresso_ns prazo do vigia (0 = sem vigia)
+ * @param inicio_ns
+ * @param fim_ns
+ */
+typedef struct invariantes {
+    controle_t* ctrl;
+
+    atomic_size_t violacoes;
+    atomic_size_t concessoes;
+    atomic_size_t em_fila;
+
+    size_t varreduras;
+    long long varredura_total_ns;
+    long long proxima_varredura_ns;
+    long long* concedido_desde_ns;
+    int* ocupantes;
+
+    long long prazo_progresso_ns;
+    pthread_t vigia;
+    atomic_bool encerrar;
+    pthread_mutex_t vigia_lock;
+    pthread_cond_t vigia_cond;
+
+    long long inicio_ns;
+    long long fim_ns;
+} invariantes_t;
+
+/**
+ * @brief Prepara a verificação e inicia o vigia
+ *
+ * Chamar com o controle, os setores e as aeronaves já registrados, antes da thread do banqueiro.
+ *
+ * @param inv
+ * @param ctrl
+ * @param prazo_progresso_s prazo sem concessões que caracteriza impasse (0 = sem vigia)
+ * @return true em sucesso
+ */
+bool invariantes_init(invariantes_t* inv, controle_t* ctrl, unsigned int prazo_progresso_s);
+
+/**
+ * @brief Registra uma violação (thread-safe); as primeiras são impressas em stderr
+ *
+ * @param inv
+ * @param formato mensagem no formato de printf
+ */
+void invariantes_violacao(invariantes_t* inv, const char* formato, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Checagens O(1) de uma concessão recém-aplicada (SOMENTE pelo banqueiro, sob banker_lock)
+ *
+ * @param inv
+ * @param aero_idx
+ * @param setor_idx
+ */
+void invariantes_concessao(invariantes_t* inv, int aero_idx, int setor_idx);
+
+/**
+ * @brief Checagens O(1) de uma liberação recém-aplicada (SOMENTE pelo banqueiro, sob banker_lock)
+ *
+ * @param inv
+ * @param aero_idx
+ * @param setor_idx
+ */
+void invariantes_liberacao(invariantes_t* inv, int aero_idx, int setor_idx);
+
+/**
+ * @brief Fim de uma passada do banqueiro: publica o tamanho das filas e, no horário, varre o estado
+ *
+ * Executado SOMENTE pelo banqueiro, sob banker_lock.
+ *
+ * @param inv
+ */
+void invariantes_passada(invariantes_t* inv);
+
+/**
+ * @brief Encerra o vigia e faz a varredura final (após o fim da thread do banqueiro)
+ *
+ * Sem aeronaves em voo, todo setor deve ter o disponível igual à capacidade.
+ *
+ * @param inv
+ */
+void invariantes_encerrar(invariantes_t* inv);
+
+/**
+ * @brief Imprime a taxa sustentada de concessões, o custo das varreduras e as violações
+ *
+ * @param inv (após invariantes_encerrar)
+ * @return size_t número de violações
+ */
+size_t invariantes_relatorio(const invariantes_t* inv);
+
+/**
+ * @brief Libera os recursos
+ *
+ * @param inv
+ */
+void invariantes_destroy(invariantes_t* inv);
+
+#endif
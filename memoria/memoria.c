@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 200112L // importante para shm_open e ftruncate
+#include "memoria.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <time.h>
+
+// Cabeçalho no início do segmento: o deslocamento livre é compartilhado por todos os processos
+typedef struct cabecalho {
+    _Atomic size_t usado;
+    size_t tamanho;
+} cabecalho_t;
+
+static cabecalho_t* segmento = NULL;
+
+// Blocos pequenos (nós de rota) não precisam de uma linha de cache inteira
+static size_t alinhamento(size_t bytes) {
+    return bytes >= CACHE_LINE_SIZE ? CACHE_LINE_SIZE : 16;
+}
+
+bool memoria_compartilhar(size_t tamanho) {
+    char nome[64];
+    snprintf(nome, sizeof(nome), "/controle_aereo.%d", (int)getpid());
+
+    int fd = shm_open(nome, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        return false;
+    }
+
+    tamanho += CACHE_LINE_SIZE; // cabeçalho
+    void* base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)tamanho) == 0) {
+        base = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (base == MAP_FAILED) {
+        perror("mmap do segmento compartilhado");
+    }
+
+    // O mapeamento mantém o segmento vivo; sem o nome ele não sobrevive a uma falha
+    close(fd);
+    shm_unlink(nome);
+    if (base == MAP_FAILED) return false;
+
+    segmento = (cabecalho_t*)base;
+    segmento->tamanho = tamanho;
+    atomic_init(&segmento->usado, CACHE_LINE_SIZE);
+    return true;
+}
+
+void memoria_encerrar(void) {
+    if (segmento == NULL) return;
+
+    munmap(segmento, segmento->tamanho);
+    segmento = NULL;
+}
+
+bool memoria_compartilhada(void) {
+    return segmento != NULL;
+}
+
+int memoria_pshared(void) {
+    return segmento != NULL ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE;
+}
+
+void memoria_mutex_init(pthread_mutex_t* m) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, memoria_pshared());
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void memoria_cond_init(pthread_cond_t* c, bool monotonico) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setpshared(&attr, memoria_pshared());
+    if (monotonico) {
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    }
+    pthread_cond_init(c, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+void* memoria_alocar(size_t n, size_t tamanho) {
+    size_t bytes = n * tamanho;
+    size_t alinh = alinhamento(bytes);
+
+    if (segmento == NULL) {
+        void* p = alinh == CACHE_LINE_SIZE ? alocar_alinhado(n, tamanho) : malloc(bytes);
+        if (p != NULL) memset(p, 0, bytes);
+        return p;
+    }
+
+    // Avanço atômico: processos de trabalho também podem alocar
+    size_t usado = atomic_load_explicit(&segmento->usado, memory_order_relaxed);
+    size_t inicio;
+    do {
+        inicio = (usado + alinh - 1) & ~(alinh - 1);
+        if (inicio + bytes > segmento->tamanho) return NULL;
+    } while (!atomic_compare_exchange_weak_explicit(&segmento->usado, &usado, inicio + bytes, memory_order_relaxed, memory_order_relaxed));
+
+    // As páginas de um segmento novo já vêm zeradas
+    return (char*)segmento + inicio;
+}
+
+void memoria_liberar(void* p) {
+    if (segmento != NULL && (char*)p >= (char*)segmento && (char*)p < (char*)segmento + segmento->tamanho) return;
+
+    free(p);
+}
+
+size_t memoria_usada(void) {
+    return segmento != NULL ? atomic_load(&segmento->usado) : 0;
+}
@@ -0,0 +1,88 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @brief Alocação do estado compartilhado entre o controle e as aeronaves
+ *
+ * Sem segmento ativo, memoria_alocar equivale a calloc (alinhado à linha de cache a partir
+ * de CACHE_LINE_SIZE bytes). Depois de memoria_compartilhar, as alocações passam a vir de um
+ * segmento POSIX de memória compartilhada (shm_open + mmap MAP_SHARED) com um alocador de
+ * avanço atômico, e os locks, condições e semáforos criados a seguir devem ser
+ * process-shared (memoria_pshared). Os processos de trabalho são criados com fork() depois do
+ * mapeamento, de forma que o segmento fica no mesmo endereço em todos eles e os ponteiros
+ * internos continuam válidos.
+ */
+
+/**
+ * @brief Cria o segmento compartilhado e o ativa para as alocações seguintes
+ *
+ * O nome do segmento é removido logo após o mapeamento: a memória é liberada quando o
+ * último processo que o mapeou termina, mesmo em caso de falha.
+ *
+ * @param tamanho capacidade do segmento em bytes (as páginas só são ocupadas ao serem tocadas)
+ * @return true em sucesso
+ */
+bool memoria_compartilhar(size_t tamanho);
+
+/**
+ * @brief Desfaz o mapeamento do segmento (após o fim de todos os processos que o usam)
+ */
+void memoria_encerrar(void);
+
+/**
+ * @brief Indica se as alocações vêm do segmento compartilhado
+ *
+ * @return true após memoria_compartilhar
+ */
+bool memoria_compartilhada(void);
+
+/**
+ * @brief Valor de pshared para os atributos de mutex, condição e semáforo
+ *
+ * @return int PTHREAD_PROCESS_SHARED com o segmento ativo; PTHREAD_PROCESS_PRIVATE caso contrário
+ */
+int memoria_pshared(void);
+
+/**
+ * @brief Inicializa um mutex (process-shared com o segmento ativo)
+ *
+ * @param m
+ */
+void memoria_mutex_init(pthread_mutex_t* m);
+
+/**
+ * @brief Inicializa uma condição (process-shared com o segmento ativo)
+ *
+ * @param c
+ * @param monotonico usa CLOCK_MONOTONIC nas esperas com prazo (CLOCK_REALTIME caso contrário)
+ */
+void memoria_cond_init(pthread_cond_t* c, bool monotonico);
+
+/**
+ * @brief Aloca um vetor zerado de `n` elementos
+ *
+ * @param n número de elementos
+ * @param tamanho tamanho de cada elemento (sizeof)
+ * @return void* ponteiro ou NULL se faltar memória (ou espaço no segmento)
+ */
+void* memoria_alocar(size_t n, size_t tamanho);
+
+/**
+ * @brief Libera um bloco de memoria_alocar (blocos do segmento só voltam com memoria_encerrar)
+ *
+ * @param p bloco ou NULL
+ */
+void memoria_liberar(void* p);
+
+/**
+ * @brief Bytes ocupados no segmento compartilhado (0 sem segmento)
+ *
+ * @return size_t
+ */
+size_t memoria_usada(void);
+
+#endif
@@ -0,0 +1,146 @@
+#include "perfil.h"
+#include "utils.h"
+
+#include <stdio.h>
+
+bool perfil_ativo = false;
+
+// Histogramas compartilhados (registro atômico); a fase do banqueiro tem um único escritor
+static histograma_t espera_lock[PERFIL_NUM_LOCKS];
+static histograma_t retencao_lock[PERFIL_NUM_LOCKS];
+static histograma_t espera_cond[PERFIL_NUM_LOCKS];
+static histograma_t duracao_fase[PERFIL_NUM_FASES];
+
+static const char* nomes_locks[PERFIL_NUM_LOCKS] = {
+    "banker_lock", "aeronave->lock", "slots_lock", "planejador", "escala"
+};
+
+static const char* nomes_fases[PERFIL_NUM_FASES] = {
+    "espera (caixa postal)", "iteração", "mensagens", "componentes", "varredura", "  segurança", "  notificação"
+};
+
+void perfil_habilitar(bool habilitado) {
+    for (int k = 0; k < PERFIL_NUM_LOCKS; k++) {
+        histograma_init(&espera_lock[k]);
+        histograma_init(&retencao_lock[k]);
+        histograma_init(&espera_cond[k]);
+    }
+    for (int f = 0; f < PERFIL_NUM_FASES; f++) {
+        histograma_init(&duracao_fase[f]);
+    }
+    perfil_ativo = habilitado;
+}
+
+long long perfil_lock(pthread_mutex_t* m, perfil_lock_t classe) {
+    if (!perfil_ativo) {
+        pthread_mutex_lock(m);
+        return 0;
+    }
+
+    long long inicio_ns = tempo_monotonico_ns();
+    pthread_mutex_lock(m);
+    long long adquirido_ns = tempo_monotonico_ns();
+
+    histograma_registrar_atomico(&espera_lock[classe], adquirido_ns - inicio_ns);
+    return adquirido_ns;
+}
+
+void perfil_unlock(pthread_mutex_t* m, perfil_lock_t classe, long long adquirido_ns) {
+    if (perfil_ativo) {
+        histograma_registrar_atomico(&retencao_lock[classe], tempo_monotonico_ns() - adquirido_ns);
+    }
+    pthread_mutex_unlock(m);
+}
+
+void perfil_cond_wait(pthread_cond_t* c, pthread_mutex_t* m, perfil_lock_t classe, long long* adquirido_ns) {
+    if (!perfil_ativo) {
+        pthread_cond_wait(c, m);
+        return;
+    }
+
+    long long inicio_ns = tempo_monotonico_ns();
+    histograma_registrar_atomico(&retencao_lock[classe], inicio_ns - *adquirido_ns);
+    pthread_cond_wait(c, m);
+    *adquirido_ns = tempo_monotonico_ns();
+    histograma_registrar_atomico(&espera_cond[classe], *adquirido_ns - inicio_ns);
+}
+
+int perfil_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, perfil_lock_t classe, const struct timespec* limite, long long* adquirido_ns) {
+    if (!perfil_ativo) {
+        return pthread_cond_timedwait(c, m, limite);
+    }
+
+    long long inicio_ns = tempo_monotonico_ns();
+    histograma_registrar_atomico(&retencao_lock[classe], inicio_ns - *adquirido_ns);
+    int res = pthread_cond_timedwait(c, m, limite);
+    *adquirido_ns = tempo_monotonico_ns();
+    histograma_registrar_atomico(&espera_cond[classe], *adquirido_ns - inicio_ns);
+    return res;
+}
+
+long long perfil_inicio(void) {
+    return perfil_ativo ? tempo_monotonico_ns() : 0;
+}
+
+void perfil_fase(perfil_fase_t fase, long long inicio_ns) {
+    if (!perfil_ativo) return;
+    histograma_registrar_atomico(&duracao_fase[fase], tempo_monotonico_ns() - inicio_ns);
+}
+
+// Largura de campo do printf para `colunas` visíveis: os acentos ocupam dois bytes em UTF-8
+static int largura(const char* texto, int colunas) {
+    int continuacoes = 0;
+    for (const char* c = texto; *c != '\0'; c++) {
+        if (((unsigned char)*c & 0xC0) == 0x80) continuacoes++;
+    }
+    return colunas + continuacoes;
+}
+
+// Uma linha: amostras, média, p50, p99, máximo (µs) e total (ms)
+static void imprimir_histograma(const char* nome, const char* medida, const histograma_t* h) {
+    if (h->total == 0) return;
+
+    printf("%-16s %-*s %10llu %10.2f %10.2f %10.2f %10.2f %12.2f\n", nome, largura(medida, 10), medida,
+           (unsigned long long)h->total,
+           histograma_media(h) / 1e3,
+           (double)histograma_percentil(h, 50) / 1e3,
+           (double)histograma_percentil(h, 99) / 1e3,
+           (double)h->max / 1e3,
+           (double)h->soma / 1e6);
+}
+
+void perfil_relatorio(void) {
+    if (!perfil_ativo) return;
+
+    printf("\n=== PERFIL DE LOCKS (µs; total em ms) ===\n");
+    printf("%-16s %-10s %10s %*s %10s %10s %*s %12s\n", "lock", "medida", "amostras",
+           largura("média", 10), "média", "p50", "p99", largura("máx", 10), "máx", "total");
+    for (int k = 0; k < PERFIL_NUM_LOCKS; k++) {
+        imprimir_histograma(nomes_locks[k], "aquisição", &espera_lock[k]);
+        imprimir_histograma(nomes_locks[k], "retenção", &retencao_lock[k]);
+        imprimir_histograma(nomes_locks[k], "condição", &espera_cond[k]);
+    }
+
+    // Fração de cada fase no tempo ativo do banqueiro (iterações, sem a espera na caixa postal)
+    double ativo = (double)duracao_fase[PERFIL_FASE_ITERACAO].soma;
+
+    printf("\n=== FASES DO BANQUEIRO (µs; total em ms) ===\n");
+    printf("%-22s %10s %*s %10s %10s %*s %12s %8s\n", "fase", "amostras",
+           largura("média", 10), "média", "p50", "p99", largura("máx", 10), "máx", "total", "% ativo");
+    for (int f = 0; f < PERFIL_NUM_FASES; f++) {
+        const histograma_t* h = &duracao_fase[f];
+        if (h->total == 0) continue;
+
+        printf("%-*s %10llu %10.2f %10.2f %10.2f %10.2f %12.2f", largura(nomes_fases[f], 22), nomes_fases[f],
+               (unsigned long long)h->total,
+               histograma_media(h) / 1e3,
+               (double)histograma_percentil(h, 50) / 1e3,
+               (double)histograma_percentil(h, 99) / 1e3,
+               (double)h->max / 1e3,
+               (double)h->soma / 1e6);
+        if (f != PERFIL_FASE_ESPERA && ativo > 0) {
+            printf(" %7.1f%%", 100.0 * (double)h->soma / ativo);
+        }
+        printf("\n");
+    }
+}
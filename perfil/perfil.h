@@ -0,0 +1,124 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Classes de lock instrumentadas (um conjunto de histogramas por classe)
+ * 
+ * PERFIL_LOCK_BANQUEIRO: banker_lock, mantido pelo banqueiro a cada passada
+ * PERFIL_LOCK_AERONAVE: lock do estado de cada aeronave (concessões e esperas por setor)
+ * PERFIL_LOCK_SLOTS: pilha de slots livres da operação contínua
+ * PERFIL_LOCK_PLANEJADOR: demandas e área de trabalho do planejador de rotas
+ * PERFIL_LOCK_ESCALA: bilhete corrente da escala
+ */
+typedef enum perfil_lock {
+    PERFIL_LOCK_BANQUEIRO = 0,
+    PERFIL_LOCK_AERONAVE,
+    PERFIL_LOCK_SLOTS,
+    PERFIL_LOCK_PLANEJADOR,
+    PERFIL_LOCK_ESCALA,
+    PERFIL_NUM_LOCKS
+} perfil_lock_t;
+
+/**
+ * @brief Fases de uma iteração da thread do banqueiro
+ * 
+ * PERFIL_FASE_ESPERA: bloqueada na caixa postal
+ * PERFIL_FASE_ITERACAO: do despertar ao fim da passada (soma das fases abaixo e do lock)
+ * PERFIL_FASE_MENSAGENS: drenagem e processamento das mensagens
+ * PERFIL_FASE_COMPONENTES: reconstrução das componentes de conflito
+ * PERFIL_FASE_VARREDURA: percurso das filas e concessões (inclui segurança e notificação)
+ * PERFIL_FASE_SEGURANCA: algoritmo de segurança de cada concessão tentada
+ * PERFIL_FASE_NOTIFICACAO: sinalização da aeronave contemplada
+ */
+typedef enum perfil_fase {
+    PERFIL_FASE_ESPERA = 0,
+    PERFIL_FASE_ITERACAO,
+    PERFIL_FASE_MENSAGENS,
+    PERFIL_FASE_COMPONENTES,
+    PERFIL_FASE_VARREDURA,
+    PERFIL_FASE_SEGURANCA,
+    PERFIL_FASE_NOTIFICACAO,
+    PERFIL_NUM_FASES
+} perfil_fase_t;
+
+// Habilitado antes da criação das threads e não muda durante a execução
+extern bool perfil_ativo;
+
+/**
+ * @brief Habilita a instrumentação (chamar antes de criar as threads)
+ * 
+ * Desabilitada, cada wrapper custa um desvio previsível além da operação original.
+ * Habilitada, custa duas a três leituras de CLOCK_MONOTONIC (vDSO) e incrementos
+ * atômicos relaxados nos histogramas da classe.
+ * 
+ * @param habilitado 
+ */
+void perfil_habilitar(bool habilitado);
+
+/**
+ * @brief pthread_mutex_lock instrumentado: registra a espera pela aquisição
+ * 
+ * @param m 
+ * @param classe 
+ * @return long long instante da aquisição (passar para perfil_unlock)
+ */
+long long perfil_lock(pthread_mutex_t* m, perfil_lock_t classe);
+
+/**
+ * @brief pthread_mutex_unlock instrumentado: registra o tempo de retenção
+ * 
+ * @param m 
+ * @param classe 
+ * @param adquirido_ns valor retornado por perfil_lock (ou atualizado pela espera em condição)
+ */
+void perfil_unlock(pthread_mutex_t* m, perfil_lock_t classe, long long adquirido_ns);
+
+/**
+ * @brief pthread_cond_wait instrumentado: encerra o trecho de retenção, registra o tempo
+ * bloqueado na condição e reinicia a retenção ao readquirir o mutex
+ * 
+ * @param c 
+ * @param m 
+ * @param classe 
+ * @param adquirido_ns instante da aquisição (atualizado)
+ */
+void perfil_cond_wait(pthread_cond_t* c, pthread_mutex_t* m, perfil_lock_t classe, long long* adquirido_ns);
+
+/**
+ * @brief pthread_cond_timedwait instrumentado (ver perfil_cond_wait)
+ * 
+ * @param c 
+ * @param m 
+ * @param classe 
+ * @param limite instante absoluto no relógio da condição
+ * @param adquirido_ns instante da aquisição (atualizado)
+ * @return int retorno de pthread_cond_timedwait
+ */
+int perfil_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, perfil_lock_t classe, const struct timespec* limite, long long* adquirido_ns);
+
+/**
+ * @brief Instante de início de uma fase (0 com a instrumentação desabilitada)
+ * 
+ * @return long long 
+ */
+long long perfil_inicio(void);
+
+/**
+ * @brief Registra a duração de uma fase iniciada em `inicio_ns`
+ * 
+ * @param fase 
+ * @param inicio_ns valor de perfil_inicio()
+ */
+void perfil_fase(perfil_fase_t fase, long long inicio_ns);
+
+/**
+ * @brief Imprime, por classe de lock, aquisições, espera, retenção e espera em condição
+ * (média, p50, p99, máximo, total) e a divisão do tempo do banqueiro entre as fases
+ */
+void perfil_relatorio(void);
+
+#endif
@@ -0,0 +1,74 @@
+#include "politica.h"
+
+#include <string.h>
+
+#define NS_POR_MS 1000000LL
+#define NS_POR_S  1000000000LL
+#define PRIORIDADE_MAX 1000
+
+long long politica_chave(const politica_t* politica, unsigned int prioridade, long long chegada_ns) {
+    long long chegada_rel_ns = chegada_ns - politica->t_inicio_ns;
+
+    switch (politica->tipo) {
+        case POLITICA_ENVELHECIMENTO:
+            // Escala em ns: p * 1s - taxa * chegada (pontos de prioridade por segundo de espera)
+            return (long long)prioridade * NS_POR_S - (long long)politica->taxa_envelhecimento * chegada_rel_ns;
+
+        case POLITICA_PRAZO: {
+            // Prioridade maior => prazo mais curto. Maior chave = menor prazo.
+            long long folga_ns = (long long)politica->prazo_max_ms * NS_POR_MS * (PRIORIDADE_MAX - (long long)prioridade) / PRIORIDADE_MAX;
+            return -(chegada_rel_ns + folga_ns);
+        }
+
+        case POLITICA_PRIORIDADE:
+        default:
+            return (long long)prioridade;
+    }
+}
+
+bool politica_parse(const char* nome, politica_tipo_t* tipo) {
+    if (strcmp(nome, "prioridade") == 0) {
+        *tipo = POLITICA_PRIORIDADE;
+    } else if (strcmp(nome, "envelhecimento") == 0) {
+        *tipo = POLITICA_ENVELHECIMENTO;
+    } else if (strcmp(nome, "prazo") == 0) {
+        *tipo = POLITICA_PRAZO;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* politica_nome(politica_tipo_t tipo) {
+    switch (tipo) {
+        case POLITICA_ENVELHECIMENTO: return "envelhecimento";
+        case POLITICA_PRAZO: return "prazo";
+        case POLITICA_PRIORIDADE:
+        default: return "prioridade";
+    }
+}
+
+bool selecao_parse(const char* nome, selecao_tipo_t* tipo) {
+    if (strcmp(nome, "fila") == 0) {
+        *tipo = SELECAO_FILA;
+    } else if (strcmp(nome, "rota-curta") == 0) {
+        *tipo = SELECAO_ROTA_CURTA;
+    } else if (strcmp(nome, "menos-bloqueio") == 0) {
+        *tipo = SELECAO_MENOS_BLOQUEIO;
+    } else if (strcmp(nome, "mista") == 0) {
+        *tipo = SELECAO_MISTA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* selecao_nome(selecao_tipo_t tipo) {
+    switch (tipo) {
+        case SELECAO_ROTA_CURTA: return "rota-curta";
+        case SELECAO_MENOS_BLOQUEIO: return "menos-bloqueio";
+        case SELECAO_MISTA: return "mista";
+        case SELECAO_FILA:
+        default: return "fila";
+    }
+}
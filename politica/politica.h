@@ -0,0 +1,100 @@
+#ifndef POLITICA_H
+#define POLITICA_H
+
+#include <stdbool.h>
+
+// Maior taxa de envelhecimento aceita: taxa * 7 dias em ns (~6e18) ainda cabe na chave (long long)
+#define POLITICA_TAXA_MAX 10000
+
+/**
+ * @brief Política de ordenação das filas de espera dos setores
+ * 
+ * POLITICA_PRIORIDADE: ordem pela prioridade estática da aeronave (comportamento original)
+ * POLITICA_ENVELHECIMENTO: prioridade efetiva cresce linearmente com o tempo de espera
+ * POLITICA_PRAZO: menor prazo primeiro (EDF), prazo = chegada + prazo_max proporcional à prioridade
+ */
+typedef enum politica_tipo {
+    POLITICA_PRIORIDADE = 0,
+    POLITICA_ENVELHECIMENTO,
+    POLITICA_PRAZO
+} politica_tipo_t;
+
+/**
+ * @brief Escolha entre as aeronaves seguras da fila quando um setor tem vaga
+ * 
+ * SELECAO_FILA: a primeira aeronave segura na ordem da política (comportamento original)
+ * SELECAO_ROTA_CURTA: menor rota restante primeiro (devolve toda a sua demanda mais cedo)
+ * SELECAO_MENOS_BLOQUEIO: primeiro quem libera a origem com mais aeronaves à espera; empate pela rota restante
+ * SELECAO_MISTA: média ponderada da prioridade estática com a pontuação de vazão (bloqueio e rota restante)
+ */
+typedef enum selecao_tipo {
+    SELECAO_FILA = 0,
+    SELECAO_ROTA_CURTA,
+    SELECAO_MENOS_BLOQUEIO,
+    SELECAO_MISTA
+} selecao_tipo_t;
+
+/**
+ * @brief Parâmetros da política de escalonamento das filas
+ * 
+ * @param tipo política em uso
+ * @param taxa_envelhecimento pontos de prioridade ganhos por segundo de espera (ENVELHECIMENTO)
+ * @param prazo_max_ms prazo de uma aeronave de prioridade 0; prioridade 1000 tem prazo 0 (PRAZO)
+ * @param t_inicio_ns instante de referência (CLOCK_MONOTONIC) para manter as chaves pequenas
+ */
+typedef struct politica {
+    politica_tipo_t tipo;
+    unsigned int taxa_envelhecimento;
+    unsigned int prazo_max_ms;
+    long long t_inicio_ns;
+} politica_t;
+
+/**
+ * @brief Calcula a chave de ordenação de uma aeronave que entra na fila (maior chave sai primeiro)
+ * 
+ * As chaves são invariantes no tempo: no envelhecimento, a prioridade efetiva
+ * p + taxa * (agora - chegada) ordena igual a p - taxa * chegada, pois o termo
+ * taxa * agora é comum a todas as aeronaves. Assim a fila nunca precisa ser reordenada.
+ * 
+ * @param politica 
+ * @param prioridade prioridade estática da aeronave (0 a 1000)
+ * @param chegada_ns instante de entrada na fila (CLOCK_MONOTONIC)
+ * @return long long chave de ordenação
+ */
+long long politica_chave(const politica_t* politica, unsigned int prioridade, long long chegada_ns);
+
+/**
+ * @brief Converte o nome de uma política ("prioridade", "envelhecimento", "prazo")
+ * 
+ * @param nome 
+ * @param tipo saída
+ * @return true se o nome é válido
+ */
+bool politica_parse(const char* nome, politica_tipo_t* tipo);
+
+/**
+ * @brief Nome legível da política
+ * 
+ * @param tipo 
+ * @return const char* 
+ */
+const char* politica_nome(politica_tipo_t tipo);
+
+/**
+ * @brief Converte o nome de uma seleção ("fila", "rota-curta", "menos-bloqueio", "mista")
+ * 
+ * @param nome 
+ * @param tipo saída
+ * @return true se o nome é válido
+ */
+bool selecao_parse(const char* nome, selecao_tipo_t* tipo);
+
+/**
+ * @brief Nome legível da seleção
+ * 
+ * @param tipo 
+ * @return const char* 
+ */
+const char* selecao_nome(selecao_tipo_t tipo);
+
+#endif
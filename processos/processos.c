@@ -0,0 +1,128 @@
+#define _POSIX_C_SOURCE 200112L // importante para kill e sem_init em processos
+#include "processos.h"
+#include "memoria.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// Corpo de um processo de trabalho: executa suas aeronaves e copia os resultados para o segmento
+static void executar_trabalhador(processos_t* processos, size_t k) {
+    size_t n = processos->num_aeronaves;
+    size_t num_proprias = n / processos->num_processos + 1;
+    pthread_t* threads = (pthread_t*)malloc(num_proprias * sizeof(pthread_t));
+    size_t* indices = (size_t*)malloc(num_proprias * sizeof(size_t));
+    if (threads == NULL || indices == NULL) _exit(1);
+
+    while (sem_wait(&processos->largada) == -1 && errno == EINTR);
+
+    size_t criadas = 0;
+    for (size_t i = k; i < n; i += processos->num_processos) {
+        int res = pthread_create(&threads[criadas], NULL, aeronave_thread, (void*)&processos->aeronaves[i]);
+        if (res != 0) {
+            fprintf(stderr, "Erro ao criar thread no processo %zu: %d\n", k, res);
+            _exit(1);
+        }
+        indices[criadas++] = i;
+    }
+
+    for (size_t t = 0; t < criadas; t++) {
+        resultado_aeronave_t* resultado;
+        pthread_join(threads[t], (void**)&resultado);
+        if (resultado == NULL) _exit(1);
+
+        processos->resultados[indices[t]] = *resultado;
+        free(resultado);
+    }
+
+    fflush(stdout);
+    _exit(0);
+}
+
+processos_t* processos_criar(size_t num_processos, aeronave_t* aeronaves, size_t num_aeronaves) {
+    if (num_processos > num_aeronaves) num_processos = num_aeronaves;
+
+    processos_t* processos = (processos_t*)memoria_alocar(1, sizeof(processos_t));
+    if (processos == NULL) return NULL;
+    processos->resultados = (resultado_aeronave_t*)memoria_alocar(num_aeronaves, sizeof(resultado_aeronave_t));
+    processos->pids = (pid_t*)memoria_alocar(num_processos, sizeof(pid_t));
+    if (processos->resultados == NULL || processos->pids == NULL) return NULL;
+
+    processos->num_processos = num_processos;
+    processos->aeronaves = aeronaves;
+    processos->num_aeronaves = num_aeronaves;
+    sem_init(&processos->largada, 1, 0);
+
+    // Evita que o buffer do stdout seja herdado e impresso por cada processo
+    fflush(stdout);
+
+    for (size_t k = 0; k < num_processos; k++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            executar_trabalhador(processos, k);
+        }
+        if (pid < 0) {
+            perror("fork");
+            for (size_t j = 0; j < k; j++) {
+                kill(processos->pids[j], SIGKILL);
+                waitpid(processos->pids[j], NULL, 0);
+            }
+            return NULL;
+        }
+        processos->pids[k] = pid;
+    }
+
+    return processos;
+}
+
+size_t processos_executar(processos_t* processos) {
+    for (size_t k = 0; k < processos->num_processos; k++) {
+        sem_post(&processos->largada);
+    }
+
+    size_t falhas = 0;
+    size_t restantes = processos->num_processos;
+    while (restantes > 0) {
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        restantes--;
+        for (size_t k = 0; k < processos->num_processos; k++) {
+            if (processos->pids[k] == pid) processos->pids[k] = 0;
+        }
+
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) continue;
+
+        falhas++;
+        if (WIFSIGNALED(status)) {
+            fprintf(stderr, "ERRO: processo de trabalho %d terminou pelo sinal %d\n", (int)pid, WTERMSIG(status));
+        } else {
+            fprintf(stderr, "ERRO: processo de trabalho %d terminou com código %d\n", (int)pid, WEXITSTATUS(status));
+        }
+
+        // Os setores do processo perdido nunca serão liberados: encerra os demais em vez de travar
+        for (size_t k = 0; k < processos->num_processos; k++) {
+            if (processos->pids[k] > 0) kill(processos->pids[k], SIGKILL);
+        }
+    }
+
+    return falhas;
+}
+
+void processos_destroy(processos_t* processos) {
+    if (processos == NULL) return;
+
+    sem_destroy(&processos->largada);
+    memoria_liberar(processos->resultados);
+    memoria_liberar(processos->pids);
+    memoria_liberar(processos);
+}
@@ -0,0 +1,63 @@
+#ifndef PROCESSOS_H
+#define PROCESSOS_H
+
+#include "aeronave.h"
+
+#include <stddef.h>
+#include <semaphore.h>
+#include <sys/types.h>
+
+/**
+ * @brief Frota do modo em lote distribuída em processos de trabalho
+ *
+ * Vive no segmento de memória compartilhada (memoria_compartilhar). O processo k executa as
+ * threads das aeronaves com aero_index % num_processos == k e devolve os resultados em
+ * `resultados`; o controle continua como uma thread do processo principal. Controle e
+ * aeronaves só trocam índices (aero_index, setor_index) pela caixa postal e pelos estados.
+ *
+ * @param largada semáforo (process-shared) que libera as aeronaves depois do controle iniciar
+ * @param resultados um resultado por aeronave, preenchido pelo processo que a executou
+ * @param pids processos de trabalho
+ * @param num_processos
+ * @param aeronaves frota (no segmento compartilhado)
+ * @param num_aeronaves
+ */
+typedef struct processos {
+    sem_t largada;
+    resultado_aeronave_t* resultados;
+    pid_t* pids;
+    size_t num_processos;
+    aeronave_t* aeronaves;
+    size_t num_aeronaves;
+} processos_t;
+
+/**
+ * @brief Cria os processos de trabalho, que aguardam a largada
+ *
+ * Deve ser chamada antes de criar qualquer thread, com as rotas e demandas já definidas.
+ *
+ * @param num_processos número de processos de trabalho
+ * @param aeronaves frota (no segmento compartilhado)
+ * @param num_aeronaves
+ * @return processos_t* no segmento compartilhado, ou NULL em caso de falha
+ */
+processos_t* processos_criar(size_t num_processos, aeronave_t* aeronaves, size_t num_aeronaves);
+
+/**
+ * @brief Libera as aeronaves e aguarda o fim de todos os processos de trabalho
+ *
+ * Um processo que falhe não derruba o controle: a falha é relatada e os demais seguem.
+ *
+ * @param processos
+ * @return size_t número de processos que não terminaram normalmente
+ */
+size_t processos_executar(processos_t* processos);
+
+/**
+ * @brief Libera os recursos (após processos_executar)
+ *
+ * @param processos
+ */
+void processos_destroy(processos_t* processos);
+
+#endif
@@ -1,4 +1,5 @@
 #include "rota.h"
+#include "memoria.h"
 
 // Função auxiliar para checar se um setor (índice) já existe na rota.
 bool setor_existe_na_rota(rota_node_t* head, setor_t* novo_setor) {
@@ -12,7 +13,7 @@ bool setor_existe_na_rota(rota_node_t* head, setor_t* novo_setor) {
     return false;
 }
 
-rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len) {
+rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len, aleatorio_t* aleatorio) {
     rota_t rota;
     rota.head = NULL;
     rota.tail = NULL;
@@ -29,14 +30,14 @@ rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len) {
     // O loop continua até que o comprimento desejado da rota seja alcançado.
     while (rota_atual_len < rota_len) {
         
-        size_t sel = rand() % setores_len;
+        size_t sel = aleatorio_intervalo(aleatorio, setores_len);
         setor_t* novo_setor = &setores[sel];
 
         // Checa se o setor sorteado já existe na rota.
         if (!setor_existe_na_rota(rota.head, novo_setor)) {
             
             // Cria o novo nó
-            rota_node_t* node = (rota_node_t*)malloc(sizeof(rota_node_t));
+            rota_node_t* node = (rota_node_t*)memoria_alocar(1, sizeof(rota_node_t));
             if (node == NULL) {
                 perror("Falha na alocação de memória para rota_node_t");
                 break; 
@@ -62,12 +63,55 @@ rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len) {
     return rota;
 }
 
+rota_t criar_rota_caminho(setor_t* setores, const int* caminho, size_t caminho_len) {
+    rota_t rota;
+    rota.head = NULL;
+    rota.tail = NULL;
+    rota.curr = NULL;
+    rota.len = 0;
+
+    for (size_t i = 0; i < caminho_len; i++) {
+        rota_node_t* node = (rota_node_t*)memoria_alocar(1, sizeof(rota_node_t));
+        if (node == NULL) {
+            perror("Falha na alocação de memória para rota_node_t");
+            break; 
+        }
+
+        node->setor = &setores[caminho[i]];
+        node->next = NULL;
+
+        if (rota.head == NULL) {
+            rota.head = rota.tail = rota.curr = node;
+        } else {
+            rota.tail->next = node;
+            rota.tail = node;
+        }
+        rota.len++;
+    }
+
+    return rota;
+}
+
+rota_t criar_rota_planejada(planejador_t* plan, setor_t* setores, size_t setores_len, aleatorio_t* aleatorio) {
+    int origem = (int)aleatorio_intervalo(aleatorio, setores_len);
+    int destino = (int)aleatorio_intervalo(aleatorio, setores_len);
+
+    // Evita rotas de um único setor quando há alternativa
+    if (setores_len > 1) {
+        while (destino == origem) destino = (int)aleatorio_intervalo(aleatorio, setores_len);
+    }
+
+    size_t len = planejador_rota(plan, origem, destino, plan->caminho);
+
+    return criar_rota_caminho(setores, plan->caminho, len);
+}
+
 void destruir_rota(rota_t rota) {
     rota_node_t* curr = rota.head;
 
     while (curr) {
         rota_node_t* next = curr->next;
-        free(curr);
+        memoria_liberar(curr);
         curr = next;
     }
 }
@@ -79,4 +123,10 @@ setor_t* rota_next_setor(rota_t *rota) {
     rota->curr = rota->curr->next;
     
     return setor;
+}
+
+setor_t* rota_peek_setor(const rota_t *rota) {
+    if (rota->curr == NULL) return NULL;
+
+    return rota->curr->setor;
 }
\ No newline at end of file
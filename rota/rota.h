@@ -2,6 +2,7 @@
 #define ROTA_H
 
 #include "setor.h"
+#include "topologia.h"
 #include <unistd.h>
 
 typedef struct setor setor_t;
@@ -36,10 +37,34 @@ typedef struct rota {
  * @param setores Lista de setores disponíveis para montar as rotas
  * @param setores_len Tamanho da lista de setores disponíveis
  * @param rota_len Tamanho desejado para a rota
+ * @param aleatorio Gerador de quem monta a rota
  * 
  * @return rota_t com setores
  */
-rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len);
+rota_t criar_rota(setor_t* setores, size_t setores_len, size_t rota_len, aleatorio_t* aleatorio);
+
+/**
+ * @brief Cria uma rota que segue um caminho de setores já definido (ex.: pelo planejador)
+ * 
+ * @param setores Lista de setores disponíveis
+ * @param caminho setor_index de cada setor da rota, em ordem
+ * @param caminho_len Tamanho do caminho
+ * 
+ * @return rota_t com os setores do caminho
+ */
+rota_t criar_rota_caminho(setor_t* setores, const int* caminho, size_t caminho_len);
+
+/**
+ * @brief Cria uma rota entre uma origem e um destino sorteados, planejada sobre a topologia
+ * 
+ * @param plan Planejador (a demanda da rota é somada aos setores)
+ * @param setores Lista de setores disponíveis
+ * @param setores_len Tamanho da lista de setores disponíveis
+ * @param aleatorio Gerador de quem monta a rota (sorteia a origem e o destino)
+ * 
+ * @return rota_t com os setores do caminho de menor custo
+ */
+rota_t criar_rota_planejada(planejador_t* plan, setor_t* setores, size_t setores_len, aleatorio_t* aleatorio);
 
 /**
  * @brief Deleta rota e libera o espaço em memória usado
@@ -55,4 +80,12 @@ void destruir_rota(rota_t rota);
  * @return setor_t* Próximo setor da rota ou NULL se não houver mais setores
  */
 setor_t* rota_next_setor(rota_t *rota);
+
+/** 
+ * @brief Retorna o próximo setor da rota SEM avançar o ponteiro interno `curr`
+ * 
+ * @param rota Rota alvo
+ * @return setor_t* Próximo setor da rota ou NULL se não houver mais setores
+ */
+setor_t* rota_peek_setor(const rota_t *rota);
 #endif
\ No newline at end of file
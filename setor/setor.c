@@ -1,21 +1,35 @@
 #define _POSIX_C_SOURCE 199309L // importante para CLOCK_MONOTONIC em time.h
 #include "setor.h"
 #include "aeronave.h"
+#include "politica.h"
 #include "utils.h"
+#include "perfil.h"
+#include "memoria.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sched.h>
+
+// Iterações do giro com a instrução de pausa antes de passar a ceder o processador
+#define GIRO_PAUSAS 64
+
+// Dica ao processador de que a thread está em espera ativa (libera recursos para o irmão SMT)
+static void pausa_cpu(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
 
 void init_setores(setor_t* setores, size_t setores_len, controle_t* controle) {
     for (size_t i = 0; i < setores_len; i++) {
         setores[i].id = create_id('S',i);
 
-        pthread_mutex_init(&setores[i].lock, NULL);
-        pthread_cond_init(&setores[i].setor_disponivel_cond, NULL);
-
-        setores[i].fila = NULL;
+        setores[i].fila_inicio = -1;
+        setores[i].fila_fim = -1;
         setores[i].fila_len = 0;
 
         setores[i].setor_index = i; // Para localizar no banqueiro
@@ -33,10 +47,6 @@ void destroy_setores(setor_t* setores, size_t setores_len) {
     // 1. Iterar sobre o array e liberar os recursos internos de CADA setor
     for (size_t i = 0; i < setores_len; i++) {
         setor_t* setor = &(setores[i]);
-        
-        // Destruir Mutex, Semáforo e Variável de Condição
-        pthread_mutex_destroy(&(setor->lock));
-        pthread_cond_destroy(&(setor->setor_disponivel_cond));
 
         // Liberar a string 'id'
         if (setor->id != NULL) {
@@ -44,168 +54,258 @@ void destroy_setores(setor_t* setores, size_t setores_len) {
             setor->id = NULL;
         }
 
-        // Liberar a fila de aeronaves
-        if (setor->fila != NULL) {
-            free(setor->fila);
-            setor->fila = NULL;
-            setor->fila_len = 0;
-        }
+        // A fila não possui memória própria (os nós pertencem ao controle)
+        setor->fila_inicio = -1;
+        setor->fila_fim = -1;
+        setor->fila_len = 0;
 
         setor->controle = NULL;
     }
 
     // Liberar a memória do array principal
-    free(setores);
+    memoria_liberar(setores);
 }
 
 void setor_solicitar_entrada(setor_t* setor, aeronave_t *aeronave) {
-    // Coloca a aeronave na fila do setor (para controle de prioridade e visibilidade)
-    // Usaremos a fila para esperar o Banqueiro se o estado for inseguro
-    // Lógica de adicionar à fila (deve ser baseada em aeronave->prioridade)
-    pthread_mutex_lock(&setor->lock);
-    entrar_fila(setor, aeronave);
-    pthread_mutex_unlock(&setor->lock);
-    
-    // Sinaliza ao controle que há uma nova solicitação
-    pthread_mutex_lock(&setor->controle->banker_lock);
-    pthread_cond_signal(&setor->controle->new_request_cond);
-    pthread_mutex_unlock(&setor->controle->banker_lock);
+    setor_solicitar_entrada_prazo(setor, aeronave, 0);
+}
+
+bool setor_solicitar_entrada_prazo(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms) {
+    setor_enviar_solicitacao(setor, aeronave);
+    return setor_aguardar_concessao_prazo(setor, aeronave, prazo_ms);
+}
+
+static bool aguardar_concessao(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms, long long espera_desde_ns);
+
+void setor_solicitar_entrada_desde(setor_t* setor, aeronave_t *aeronave, long long inicio_espera_ns) {
+    setor_enviar_solicitacao(setor, aeronave);
+    aguardar_concessao(setor, aeronave, 0, inicio_espera_ns);
+}
+
+void setor_enviar_solicitacao(setor_t* setor, aeronave_t *aeronave) {
+    // Apenas posta o pedido na caixa postal do controle: a inserção na fila do setor
+    // (na posição definida pela política) e a concessão são feitas pelo banqueiro
+    mensagem_t* msg = &aeronave->estado->msg_solicitacao;
+    caixa_postal_reservar(msg);
+    msg->tipo = MSG_SOLICITACAO;
+    msg->aero_index = aeronave->aero_index;
+    msg->setor_index = setor->setor_index;
+
+    caixa_postal_enviar(&setor->controle->caixa, msg);
+}
+
+void setor_aguardar_concessao(setor_t* setor, aeronave_t *aeronave) {
+    setor_aguardar_concessao_prazo(setor, aeronave, 0);
+}
+
+// Pede ao banqueiro o cancelamento da solicitação pendente no setor
+static void enviar_cancelamento(setor_t* setor, aeronave_t *aeronave) {
+    mensagem_t* msg = &aeronave->estado->msg_cancelamento;
+    caixa_postal_reservar(msg);
+    msg->tipo = MSG_CANCELAMENTO;
+    msg->aero_index = aeronave->aero_index;
+    msg->setor_index = setor->setor_index;
+
+    caixa_postal_enviar(&setor->controle->caixa, msg);
+}
+
+// Janela de giro: um múltiplo da latência das concessões curtas, ou nenhuma se poucas concessões
+// recentes chegaram dentro do giro máximo (esperas na fila: o giro só queimaria processador)
+static long long janela_giro(const controle_t* ctrl, const aeronave_estado_t* estado) {
+    if (estado->fracao_curta < GIRO_FRACAO_MIN) return 0;
+
+    long long janela_ns = GIRO_FATOR * estado->latencia_curta_ns;
+    return janela_ns < ctrl->giro_max_ns ? janela_ns : ctrl->giro_max_ns;
+}
+
+// Atualiza as médias com a latência de uma concessão (a primeira concessão curta inicia a média)
+static void registrar_latencia(const controle_t* ctrl, aeronave_estado_t* estado, long long latencia_ns) {
+    bool curta = latencia_ns <= ctrl->giro_max_ns;
+    int alvo = curta ? 1024 : 0;
+    estado->fracao_curta = (unsigned int)((int)estado->fracao_curta + ((alvo - (int)estado->fracao_curta) >> GIRO_SUAVIZACAO));
+    if (!curta) return;
+
+    if (estado->latencia_curta_ns == 0) {
+        estado->latencia_curta_ns = latencia_ns;
+    } else {
+        estado->latencia_curta_ns += (latencia_ns - estado->latencia_curta_ns) >> GIRO_SUAVIZACAO;
+    }
+}
+
+// Espera ativa pela concessão, sem o lock da aeronave: pausa nas primeiras iterações e depois cede
+// o processador (com menos núcleos que threads, o banqueiro precisa dele para conceder)
+static bool girar_ate_concessao(const aeronave_estado_t* estado, int setor_idx, long long janela_ns) {
+    if (atomic_load_explicit(&estado->concessao_sinal, memory_order_acquire) == setor_idx) return true;
+    if (janela_ns <= 0) return false;
+
+    long long limite_ns = tempo_monotonico_ns() + janela_ns;
+    for (unsigned int i = 0; tempo_monotonico_ns() < limite_ns; i++) {
+        if (i < GIRO_PAUSAS) {
+            pausa_cpu();
+        } else {
+            sched_yield();
+        }
+        if (atomic_load_explicit(&estado->concessao_sinal, memory_order_acquire) == setor_idx) return true;
+    }
+    return false;
+}
+
+bool setor_aguardar_concessao_prazo(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms) {
+    return aguardar_concessao(setor, aeronave, prazo_ms, 0);
+}
+
+// espera_desde_ns: início da espera registrada para o salto (0 = esta chamada); o prazo e a
+// latência usada pelo giro contam sempre a partir desta chamada
+static bool aguardar_concessao(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms, long long espera_desde_ns) {
+    long long inicio_ns = tempo_monotonico_ns();
+    long long limite_ns = inicio_ns + (long long)prazo_ms * 1000000LL;
+    bool cancelando = false;
 
-    struct timespec tempo_inicio; // Inicio do tempo de espera
-    clock_gettime(CLOCK_MONOTONIC, &tempo_inicio);
+    aeronave_estado_t* estado = aeronave->estado;
+
+    // Giro antes do bloqueio: quando a concessão sai em microssegundos (permanência curta, lookahead)
+    // evita o ciclo dormir/acordar do kernel, que dominaria a latência de cada salto
+    long long janela_ns = janela_giro(setor->controle, estado);
+    if (prazo_ms > 0 && janela_ns > limite_ns - inicio_ns) janela_ns = limite_ns - inicio_ns;
+    bool no_giro = girar_ate_concessao(estado, setor->setor_index, janela_ns);
     
-    pthread_mutex_lock(&setor->lock);
+    long long adquirido_ns = perfil_lock(&estado->lock, PERFIL_LOCK_AERONAVE);
 
     printf_timestamped("[AERONAVE %s] ESPERANDO concessão do BANQUEIRO para setor %s...\n", aeronave->id, setor->id);
 
-    while (setor->controle->allocation[aeronave->aero_index][setor->setor_index] <= 0) {
-        // Espera até ser acordada quando o setor estiver disponível
-        pthread_cond_wait(&setor->setor_disponivel_cond, &setor->lock);
+    // A aeronave só espera pela sua própria notificação; o banqueiro já a retirou da fila
+    while (estado->setor_concedido != setor->setor_index) {
+        if (cancelando) {
+            // Aguarda a resposta do banqueiro: concessão (acima) ou confirmação do cancelamento
+            if (estado->cancelamento_confirmado) break;
+            perfil_cond_wait(&estado->concessao_cond, &estado->lock, PERFIL_LOCK_AERONAVE, &adquirido_ns);
+        } else if (prazo_ms == 0) {
+            perfil_cond_wait(&estado->concessao_cond, &estado->lock, PERFIL_LOCK_AERONAVE, &adquirido_ns);
+        } else if (tempo_monotonico_ns() >= limite_ns) {
+            enviar_cancelamento(setor, aeronave);
+            cancelando = true;
+        } else {
+            struct timespec ts = { .tv_sec = limite_ns / 1000000000LL, .tv_nsec = limite_ns % 1000000000LL };
+            perfil_cond_timedwait(&estado->concessao_cond, &estado->lock, PERFIL_LOCK_AERONAVE, &ts, &adquirido_ns);
+        }
     }
-    // Remove a aeronave da fila agora que ela adquiriu o recurso
-    sair_fila(setor, aeronave);
 
-    struct timespec tempo_fim; // Fim do tempo de espera
-    clock_gettime(CLOCK_MONOTONIC, &tempo_fim);
+    bool concedido = estado->setor_concedido == setor->setor_index;
+    if (concedido) {
+        estado->setor_concedido = -1;
+        atomic_store_explicit(&estado->concessao_sinal, -1, memory_order_relaxed);
+    } else {
+        estado->cancelamento_confirmado = false;
+        estado->timeouts++;
+    }
     
     // Calculo e incremento da espera total
-    long long delta_ns = (tempo_fim.tv_sec - tempo_inicio.tv_sec) * 1000000000LL + (tempo_fim.tv_nsec - tempo_inicio.tv_nsec);
+    long long agora_ns = tempo_monotonico_ns();
+    long long delta_ns = agora_ns - (espera_desde_ns > 0 ? espera_desde_ns : inicio_ns);
+
+    // A latência de cada concessão ajusta a janela do próximo giro
+    if (concedido) {
+        registrar_latencia(setor->controle, estado, agora_ns - inicio_ns);
+        if (no_giro) {
+            estado->esperas_giro++;
+        } else {
+            estado->esperas_bloqueio++;
+        }
+    }
 
-    pthread_mutex_lock(&aeronave->lock);
-    aeronave->espera_total_ns += delta_ns;
-    pthread_mutex_unlock(&aeronave->lock);
+    estado->espera_total_ns += delta_ns;
+    if (delta_ns > estado->espera_max_ns) {
+        estado->espera_max_ns = delta_ns;
+    }
+    perfil_unlock(&estado->lock, PERFIL_LOCK_AERONAVE, adquirido_ns);
 
-    printf_timestamped("[AERONAVE %s] ADQUIRIU ACESSO ao setor %s.\n", aeronave->id, setor->id);
-    pthread_mutex_unlock(&setor->lock);
+    if (concedido) {
+        printf_timestamped("[AERONAVE %s] ADQUIRIU ACESSO ao setor %s.\n", aeronave->id, setor->id);
+    } else {
+        printf_timestamped("[AERONAVE %s] CANCELOU a solicitação do setor %s (prazo de %u ms).\n", aeronave->id, setor->id, prazo_ms);
+    }
+    return concedido;
 }
 
 void setor_liberar_saida(setor_t *setor, aeronave_t *aeronave) {
-    // Bloqueia as matrizes do banqueiro para liberar o recurso
-    pthread_mutex_lock(&setor->controle->banker_lock);
     printf_timestamped("[AERONAVE %s] LIBERANDO setor %s...\n", aeronave->id, setor->id);
     
-    // ** CHAMADA AO CORAÇÃO DO BANQUEIRO **
-    liberar_recurso_banqueiro(setor->controle, aeronave->aero_index, setor->setor_index);
-
-    pthread_cond_signal(&setor->controle->new_request_cond);
-    
-    pthread_mutex_unlock(&setor->controle->banker_lock);
+    // A liberação no banqueiro é feita pelo controle ao consumir a mensagem
+    mensagem_t* msg = &aeronave->estado->msg_liberacao;
+    caixa_postal_reservar(msg);
+    msg->tipo = MSG_LIBERACAO;
+    msg->aero_index = aeronave->aero_index;
+    msg->setor_index = setor->setor_index;
+
+    caixa_postal_enviar(&setor->controle->caixa, msg);
 }
 
-void entrar_fila(setor_t* setor, aeronave_t* aeronave) {
+bool entrar_fila(setor_t* setor, aeronave_t* aeronave) {
     printf_timestamped("[AERONAVE %s] TENTANDO ADICIONAR na fila de ESPERA do setor %s (Prioridade: %u)\n", 
            aeronave->id, setor->id, aeronave->prioridade);
-    
-    size_t new_len = setor->fila_len + 1;
-    size_t insert_index = 0;
 
-    // Aloca espaço para o novo elemento.
-    aeronave_t* nova_fila = (aeronave_t*)realloc(setor->fila, new_len * sizeof(aeronave_t));
-    
-    if (nova_fila == NULL) {
-        fprintf(stderr, "Erro de realloc ao adicionar aeronave %s na fila do setor %s\n", 
-                aeronave->id, setor->id);
-        pthread_mutex_unlock(&setor->lock);
-        return;
-    }
+    fila_no_t* nos = setor->controle->fila_nos;
+    fila_no_t* no = &nos[aeronave->aero_index];
 
-    setor->fila = nova_fila; // Atualiza o ponteiro para a nova memória
-    
-    // Percorre a fila para encontrar a primeira aeronave com prioridade MENOR
-    // do que a aeronave que está entrando.
-    // Isso define o índice onde a nova aeronave deve ser inserida.
-    for (size_t i = 0; i < setor->fila_len; i++) {
-        if (aeronave->prioridade > setor->fila[i].prioridade) {
-            insert_index = i;
-            break; 
-        }
-        // Se a nova aeronave tem prioridade menor ou igual a todos, ela vai para o final.
-        insert_index = new_len - 1; 
-    }
-    
-    // Caso especial: Fila Vazia (setor->fila_len == 0), insert_index será 0.
-    if (setor->fila_len == 0) {
-        insert_index = 0;
+    if (no->setor_index != -1) {
+        fprintf(stderr, "Aeronave %s já está na fila do setor %d\n", aeronave->id, no->setor_index);
+        return false;
     }
+
+    no->chave = politica_chave(&setor->controle->politica, aeronave->prioridade, tempo_monotonico_ns());
     
-    // Desloca todos os elementos a partir do insert_index uma posição para frente
-    // (do final da fila em direção ao índice de inserção) para abrir espaço.
-    for (size_t i = setor->fila_len; i > insert_index; i--) {
-        setor->fila[i] = setor->fila[i - 1];
+    // Caminha a partir do FINAL até a primeira aeronave com chave MAIOR ou IGUAL,
+    // mantendo a ordem de chegada entre chaves iguais. Nas políticas de envelhecimento
+    // e prazo quem chega depois tende a ter chave menor, então a inserção é quase O(1).
+    int anterior = setor->fila_fim;
+    size_t insert_index = setor->fila_len;
+    while (anterior != -1 && nos[anterior].chave < no->chave) {
+        anterior = nos[anterior].ant;
+        insert_index--;
     }
-    
-    // Insere a nova aeronave no espaço vazio.
-    setor->fila[insert_index] = *aeronave; 
 
-    setor->fila_len = new_len;
+    // Insere a nova aeronave logo após 'anterior' (ou no início, se anterior == -1)
+    int seguinte = anterior == -1 ? setor->fila_inicio : nos[anterior].prox;
+    no->ant = anterior;
+    no->prox = seguinte;
+    no->setor_index = setor->setor_index;
+
+    if (anterior == -1) setor->fila_inicio = aeronave->aero_index;
+    else nos[anterior].prox = aeronave->aero_index;
+
+    if (seguinte == -1) setor->fila_fim = aeronave->aero_index;
+    else nos[seguinte].ant = aeronave->aero_index;
+
+    setor->fila_len++;
     
     printf_timestamped("[AERONAVE %s] Nova aeronave ADICIONADA a fila de ESPERA do setor %s no índice %zu (Prioridade: %u)\n", 
            aeronave->id, setor->id, insert_index, aeronave->prioridade);
-
+    return true;
 }
 
-void sair_fila(setor_t* setor, aeronave_t* aeronave) {
+bool sair_fila(setor_t* setor, aeronave_t* aeronave) {
     printf_timestamped("[AERONAVE %s] TENTANDO REMOVER da fila de ESPERA do setor %s\n", aeronave->id, setor->id);
 
-    size_t aero_index = -1;
+    fila_no_t* nos = setor->controle->fila_nos;
+    fila_no_t* no = &nos[aeronave->aero_index];
 
-    // Localizando o index a ser removido
-    for (size_t i = 0; i < setor->fila_len; i++) {
-        if (strcmp(setor->fila[i].id, aeronave->id) == 0) { 
-            aero_index = i;
-            break; 
-        }
-    }
-
-    if (aero_index == (size_t)-1) {
+    if (no->setor_index != setor->setor_index) {
         printf("Aeronave %s não encontrada na fila do setor %s\n", aeronave->id, setor->id);
-        return;
+        return false;
     }
 
-    // Move todos os elementos após o índice 'aero_index' uma posição para trás
-    for (size_t i = aero_index; i < setor->fila_len - 1; i++) {
-        setor->fila[i] = setor->fila[i + 1];
-    }
+    // Desencadeia o nó em O(1)
+    if (no->ant == -1) setor->fila_inicio = no->prox;
+    else nos[no->ant].prox = no->prox;
 
-    // Realocação e atribuição
-    size_t new_len = setor->fila_len - 1;
-    aeronave_t* nova_fila;
-    
-    // Se a fila esvaziou, new_len será 0. realloc(ptr, 0) == free(ptr), retorna NULL.
-    nova_fila = (aeronave_t*)realloc(setor->fila, new_len * sizeof(aeronave_t));
-    
-    // Checagem de falha de alocação: 
-    // Se nova_fila é NULL E a fila NÃO esvaziou (new_len > 0), é um erro.
-    if (nova_fila == NULL && new_len > 0) {
-        printf("Erro de realloc ao remover aeronave %s. Memória original preservada.\n", aeronave->id);
-        return;
-    }
+    if (no->prox == -1) setor->fila_fim = no->ant;
+    else nos[no->prox].ant = no->ant;
 
-    // Atualiza o ponteiro e o tamanho
-    setor->fila = nova_fila; // Se new_len=0, nova_fila é NULL, e setor->fila aponta para NULL.
-    setor->fila_len = new_len;
+    no->prox = -1;
+    no->ant = -1;
+    no->setor_index = -1;
+    setor->fila_len--;
     
     printf_timestamped("[AERONAVE %s] REMOVIDA da fila de ESPERA do setor %s (Tamanho: %zu)\n", aeronave->id, setor->id, setor->fila_len);
-
-    pthread_mutex_unlock(&setor->lock);
+    return true;
 }
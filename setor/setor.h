@@ -2,6 +2,7 @@
 #define SETOR_H
 
 #include "controle.h"
+#include "utils.h"
 
 #include <pthread.h>
 #include <semaphore.h>
@@ -9,38 +10,60 @@
 typedef struct aeronave aeronave_t;
 typedef struct controle controle_t;
 
+/**
+ * @brief Nó da fila de espera de um setor (lista duplamente encadeada intrusiva por aero_index)
+ * 
+ * Cada aeronave espera em no máximo uma fila por vez, então os nós ficam em um vetor
+ * do controle indexado por aero_index. Remover e reposicionar uma aeronave custa O(1)
+ * mais a caminhada até a nova posição, sem realocar nem deslocar a fila.
+ * 
+ * @param chave chave de ordenação calculada pela política (maior chave sai primeiro)
+ * @param prox aero_index do próximo nó (-1 se for o último)
+ * @param ant aero_index do nó anterior (-1 se for o primeiro)
+ * @param setor_index setor em cuja fila a aeronave está (-1 se nenhuma)
+ */
+typedef struct fila_no {
+    long long chave;
+    int prox;
+    int ant;
+    int setor_index;
+} fila_no_t;
+
 /**
  * @brief Representação de um setor que será usado por uma aeronave (recurso compartilhado)
  * 
- * @param id identificação unica do setor
- * @param lock lock do setor
- * @param fila fila de aeronaves para entrarem no setor
+ * A fila é alterada apenas pela thread do banqueiro (as aeronaves se comunicam pela
+ * caixa postal do controle). Os campos quentes vêm primeiro e a struct é alinhada à
+ * linha de cache, de forma que setores vizinhos no vetor não compartilham linhas.
+ * 
+ * @param fila_inicio aero_index da primeira aeronave da fila (-1 se vazia)
+ * @param fila_fim aero_index da última aeronave da fila (-1 se vazia)
  * @param fila_len tamanho da fila de aeronaves
+ * @param setor_index O ID do setor na matriz do banqueiro (0 a N-1)
+ * @param controle Ponteiro para o controle global
+ * @param id identificação unica do setor
  */
 typedef struct setor {
-    char* id;
-    pthread_mutex_t lock;
-    aeronave_t* fila;
+    int fila_inicio;
+    int fila_fim;
     size_t fila_len;
 
-    controle_t* controle; // Ponteiro para o controle global
-    // Usaremos a COND_T para acordar a aeronave na fila quando um setor for liberado
-    pthread_cond_t setor_disponivel_cond; 
-    
-    // O ID do setor na matriz do banqueiro (0 a N-1)
+    // Dados frios (somente leitura após init_setores)
     int setor_index;
-} setor_t;
+    controle_t* controle;
+    char* id;
+} ALINHADO_CACHE setor_t;
 
 /**
  * @brief Inicializa os setores em uma lista dinâmica
  * 
- * @param setores lista para ser inicializada
+ * @param setores lista para ser inicializada (alocada com alocar_alinhado)
  * @param setores_len tamanho da lista
  */
 void init_setores(setor_t* setores, size_t setores_len, controle_t* controle);
 
 /**
- * @brief Libera todos os recursos internos (ID, semáforo, mutex, fila) 
+ * @brief Libera todos os recursos internos (ID, fila) 
  * de cada setor em um array e, em seguida, libera o próprio array.
  *
  * @param setores Ponteiro para o array dinâmico de estruturas setor_t.
@@ -49,7 +72,9 @@ void init_setores(setor_t* setores, size_t setores_len, controle_t* controle);
 void destroy_setores(setor_t* setores, size_t setores_len);
 
 /**
- * @brief Set the or solicitar entrada object
+ * @brief Solicita a entrada no setor e bloqueia até a concessão do banqueiro
+ * 
+ * Equivale a setor_enviar_solicitacao() seguido de setor_aguardar_concessao().
  * 
  * @param setor
  * @param aeronave 
@@ -57,7 +82,66 @@ void destroy_setores(setor_t* setores, size_t setores_len);
 void setor_solicitar_entrada(setor_t* setor, aeronave_t *aeronave);
 
 /**
- * @brief Set the or liberar saida object
+ * @brief Solicita a entrada no setor e bloqueia até a concessão ou até o prazo expirar
+ * 
+ * @param setor
+ * @param aeronave 
+ * @param prazo_ms prazo da espera (0 = sem prazo)
+ * @return true se o setor foi concedido
+ * @return false se o prazo expirou (ver setor_aguardar_concessao_prazo)
+ */
+bool setor_solicitar_entrada_prazo(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms);
+
+/**
+ * @brief Solicita a entrada e bloqueia até a concessão, registrando a espera desde um instante
+ * anterior (escala abandonada: a espera pelo bilhete e a espera online são uma única amostra)
+ * 
+ * @param setor
+ * @param aeronave 
+ * @param inicio_espera_ns início da espera do salto (tempo_monotonico_ns)
+ */
+void setor_solicitar_entrada_desde(setor_t* setor, aeronave_t *aeronave, long long inicio_espera_ns);
+
+/**
+ * @brief Envia a solicitação do setor para a caixa postal do banqueiro, sem bloquear
+ * 
+ * Usado pelo modo lookahead para solicitar o próximo setor enquanto a aeronave
+ * ainda voa no atual; a concessão fica reservada até setor_aguardar_concessao().
+ * 
+ * @param setor 
+ * @param aeronave 
+ */
+void setor_enviar_solicitacao(setor_t* setor, aeronave_t *aeronave);
+
+/**
+ * @brief Bloqueia até o banqueiro notificar a concessão do setor solicitado
+ * 
+ * O tempo bloqueado aqui é somado à espera total da aeronave.
+ * 
+ * @param setor 
+ * @param aeronave 
+ */
+void setor_aguardar_concessao(setor_t* setor, aeronave_t *aeronave);
+
+/**
+ * @brief Variante de setor_aguardar_concessao() com prazo
+ * 
+ * Ao expirar, envia MSG_CANCELAMENTO e continua bloqueada até o banqueiro responder: se a
+ * concessão saiu antes do cancelamento ser processado ela é aceita normalmente; caso contrário
+ * o banqueiro retira a aeronave da fila, atualiza a demanda e reposiciona `rota.curr` no
+ * próximo setor a tentar (desvio pela topologia ou nova ordem dos setores restantes).
+ * O timeout é contabilizado no estado da aeronave e o tempo esperado, na espera total.
+ * 
+ * @param setor 
+ * @param aeronave 
+ * @param prazo_ms prazo da espera (0 = sem prazo)
+ * @return true se o setor foi concedido
+ * @return false se o prazo expirou e o cancelamento foi confirmado
+ */
+bool setor_aguardar_concessao_prazo(setor_t* setor, aeronave_t *aeronave, unsigned int prazo_ms);
+
+/**
+ * @brief Avisa o banqueiro (pela caixa postal) que a aeronave saiu do setor, sem bloquear
  * 
  * @param setor 
  * @param aeronave 
@@ -65,27 +149,22 @@ void setor_solicitar_entrada(setor_t* setor, aeronave_t *aeronave);
 void setor_liberar_saida(setor_t *setor, aeronave_t *aeronave);
 
 /**
- * @brief Adiciona uma aeronave a fila do setor
+ * @brief Adiciona uma aeronave a fila do setor na posição dada pela política (executado SOMENTE pelo banqueiro)
  * 
  * @param setor setor alvo
  * @param aeronave aeronave a ser adicionado
+ * @return true se inseriu; false se a aeronave já estava em uma fila (nada é alterado)
  */
-void entrar_fila(setor_t* setor, aeronave_t* aeronave);
+bool entrar_fila(setor_t* setor, aeronave_t* aeronave);
 
 /**
- * @brief Remove uma aeronave da fila do setor
+ * @brief Remove uma aeronave da fila do setor (executado SOMENTE pelo banqueiro)
  * 
  * @param setor setor alvo
  * @param aeronave aeronave a ser removido
+ * @return true se removeu; false se a aeronave não estava na fila deste setor (nada é alterado)
  */
-void sair_fila(setor_t* setor, aeronave_t* aeronave);
+bool sair_fila(setor_t* setor, aeronave_t* aeronave);
 
-/**
- * @brief Pega a próxima aeronave da fila com base na prioridade
- * 
- * @param setor setor a ser retirado a aeronave
- * @return aeronave_t* aeronave que entrará no setor
- */
-aeronave_t* proximo(setor_t* setor);
 
 #endif
@@ -0,0 +1,371 @@
+#include "simulacao.h"
+#include "continuo.h"
+#include "perfil.h"
+#include "memoria.h"
+#include "checkpoint.h"
+#include "rota.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Comparador crescente para qsort
+static int comparar_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Capacidade do segmento compartilhado: estruturas fixas, rotas de até m nós e folga para o alinhamento
+static size_t tamanho_compartilhado(size_t n, size_t m) {
+    size_t por_aeronave = sizeof(aeronave_t) + sizeof(aeronave_estado_t) + sizeof(resultado_aeronave_t) + sizeof(fila_no_t)
+                          + 2 * sizeof(int) + sizeof(bool) + sizeof(pid_t) + 2 * m * sizeof(rota_node_t) + 2 * sizeof(candidato_t);
+    size_t por_setor = sizeof(setor_t) + 4 * sizeof(int);
+    size_t componentes = (n + m + 1) * (2 * sizeof(int) + sizeof(size_t)) + (n + 1) * sizeof(int);
+
+    return sizeof(controle_t) + sizeof(processos_t) + banqueiro_tamanho(n, m) + n * por_aeronave + m * por_setor + componentes + (1 << 20);
+}
+
+bool simulacao_criar(simulacao_t* sim, const config_t* config, bool imprimir) {
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->imprimir = imprimir;
+    config = &sim->config;
+
+    // Na restauração as dimensões vêm do instantâneo
+    checkpoint_cabecalho_t checkpoint;
+    if (config->arquivo_restauracao != NULL) {
+        if (!checkpoint_ler_cabecalho(config->arquivo_restauracao, &checkpoint)) {
+            return false;
+        }
+        sim->config.num_aeronaves = checkpoint.num_aeronaves;
+        sim->config.num_setores = checkpoint.num_setores;
+    }
+
+    size_t num_aero = config->num_aeronaves;
+    size_t num_set = config->num_setores;
+
+    if (imprimir) {
+        printf("Iniciando simulação com %zu %s e %zu setores%s (fila: %s)...\n", num_aero, config->continuo ? "slots de aeronaves" : "aeronaves",
+               num_set, config->lookahead ? " (lookahead)" : "", politica_nome(config->politica));
+        if (config->num_capacidades > 1 || config->capacidades[0] > 1) {
+            printf("Capacidade dos setores:");
+            for (size_t j = 0; j < num_set; j++) {
+                printf(" %u", config_capacidade(config, j));
+            }
+            printf("\n");
+        }
+    }
+
+    // Com processos de trabalho, todo o estado que eles tocam é alocado no segmento compartilhado
+    if (config->processos > 0 && !memoria_compartilhar(tamanho_compartilhado(num_aero, num_set))) {
+        fprintf(stderr, "Erro ao criar o segmento de memória compartilhada\n");
+        return false;
+    }
+
+    sim->controle = (controle_t*)memoria_alocar(1, sizeof(controle_t));
+    if (sim->controle == NULL) return false;
+    controle_t* ctrl = sim->controle;
+    init_controle(ctrl, num_aero, num_set, config);
+
+    // Setores e estados das aeronaves são alinhados à linha de cache (evita falso compartilhamento)
+    sim->setores = (setor_t*)memoria_alocar(num_set, sizeof(setor_t));
+    if (sim->setores == NULL) return false;
+    init_setores(sim->setores, num_set, ctrl);
+
+    // Topologia opcional: rotas planejadas sobre o grafo de setores, desviando da contenção
+    if (config->topologia != NULL) {
+        bool ok = strcmp(config->topologia, "grade") == 0 ? topologia_gerar_grade(&sim->topologia, num_set)
+                                                          : topologia_carregar(&sim->topologia, config->topologia, num_set);
+        if (!ok || !planejador_init(&sim->planejador, &sim->topologia, config->peso_contencao)) {
+            fprintf(stderr, "Erro ao preparar a topologia '%s'\n", config->topologia);
+            return false;
+        }
+        ctrl->planejador = &sim->planejador;
+    }
+
+    sim->aeronaves = (aeronave_t*)memoria_alocar(num_aero, sizeof(aeronave_t));
+    sim->estados = (aeronave_estado_t*)memoria_alocar(num_aero, sizeof(aeronave_estado_t));
+    if (sim->aeronaves == NULL || sim->estados == NULL) return false;
+    init_aeronaves(sim->aeronaves, sim->estados, num_aero, ctrl);
+
+    // Na operação contínua as rotas são criadas a cada chegada; na restauração vêm do instantâneo
+    for (size_t i = 0; !config->continuo && config->arquivo_restauracao == NULL && i < num_aero; i++) {
+        if (ctrl->planejador != NULL) {
+            sim->aeronaves[i].rota = criar_rota_planejada(ctrl->planejador, sim->setores, num_set, &ctrl->aleatorio);
+        } else {
+            sim->aeronaves[i].rota = criar_rota(sim->setores, num_set, config_comprimento_rota(config, num_set, &ctrl->aleatorio), &ctrl->aleatorio);
+        }
+
+        // Alocações para o banqueiro
+        controle_definir_demanda(ctrl, (int)i, &sim->aeronaves[i].rota);
+    }
+
+    if (imprimir && !config->continuo && ctrl->planejador != NULL) {
+        planejador_relatorio(ctrl->planejador);
+    }
+
+    ctrl->aeronaves = sim->aeronaves; // Registra o vetor de aeronaves no controle
+    ctrl->estados = sim->estados;
+
+    if (config->arquivo_restauracao != NULL) {
+        if (!checkpoint_restaurar(config->arquivo_restauracao, ctrl)) {
+            return false;
+        }
+        sim->decorrido_ns = checkpoint.decorrido_ns;
+        if (imprimir) {
+            printf("Retomando do checkpoint %s (instante %.2f s, fila: %s)\n", config->arquivo_restauracao,
+                   (double)sim->decorrido_ns / 1e9, politica_nome(ctrl->politica.tipo));
+        }
+    }
+
+    // Escala: ordem de entrada compilada a partir das rotas, com a permanência média de usar_setor
+    if (config->escala) {
+        if (!escala_compilar(&sim->escala, sim->aeronaves, num_aero, num_set, ctrl->capacidade, VOO_MEDIO_MS, config->tolerancia_escala_ms)) {
+            fprintf(stderr, "Erro ao compilar a escala\n");
+            return false;
+        }
+        if (imprimir) {
+            printf("Escala compilada: %zu bilhetes | makespan planejado %.2f s\n", sim->escala.num_bilhetes,
+                   (double)sim->escala.makespan_planejado_ms / 1000.0);
+        }
+        ctrl->escala = &sim->escala;
+    }
+
+    // Soak: o verificador acompanha o controle desde a primeira passada do banqueiro
+    if (config->soak) {
+        if (!invariantes_init(&sim->invariantes, ctrl, config->vigia_s)) {
+            fprintf(stderr, "Erro ao iniciar a verificação de invariantes\n");
+            return false;
+        }
+        ctrl->invariantes = &sim->invariantes;
+    }
+
+    // Resultados zerados: uma execução interrompida só libera os que chegaram
+    if (!config->continuo) {
+        sim->threads = (pthread_t*)malloc(num_aero * sizeof(pthread_t));
+        sim->resultados = (resultado_aeronave_t**)calloc(num_aero, sizeof(resultado_aeronave_t*));
+        if (sim->threads == NULL || sim->resultados == NULL) return false;
+    }
+
+    return true;
+}
+
+// Operação contínua: o gerador de chegadas roda nesta thread até a última aposentadoria
+static int executar_continuo_simulacao(simulacao_t* sim, pthread_t ctrl_thread) {
+    const config_t* config = &sim->config;
+    controle_t* ctrl = sim->controle;
+
+    resultado_continuo_t resultado;
+    int erro = executar_continuo(config, ctrl, sim->setores, ctrl->num_setores, sim->aeronaves, &resultado);
+
+    controle_encerrar(ctrl);
+    pthread_join(ctrl_thread, NULL);
+    if (config->soak) {
+        invariantes_encerrar(&sim->invariantes);
+    }
+
+    sim->resultado.makespan_ns = resultado.duracao_ns;
+    sim->resultado.concessoes = ctrl->estatisticas.concessoes;
+    sim->resultado.verificacoes_seguranca = ctrl->estatisticas.verificacoes_seguranca;
+    if (config->soak) {
+        sim->resultado.violacoes = atomic_load(&sim->invariantes.violacoes);
+    }
+    if (!sim->imprimir) return erro == 0 && sim->resultado.violacoes == 0 ? 0 : 1;
+
+    imprimir_resultado_continuo(&resultado, &ctrl->estatisticas);
+    controle_relatorio_seguranca(ctrl);
+    controle_relatorio_selecao(ctrl);
+    controle_relatorio_esperas(ctrl);
+    if (config->prazo_setor_ms > 0) {
+        controle_relatorio_cancelamentos(ctrl);
+    }
+    if (config->perfil) {
+        perfil_relatorio();
+    }
+    if (config->soak) {
+        invariantes_relatorio(&sim->invariantes);
+    }
+    if (ctrl->planejador != NULL) {
+        planejador_relatorio(ctrl->planejador);
+    }
+
+    return erro == 0 && sim->resultado.violacoes == 0 ? 0 : 1;
+}
+
+int simulacao_executar(simulacao_t* sim) {
+    const config_t* config = &sim->config;
+    controle_t* ctrl = sim->controle;
+    size_t num_aero = ctrl->num_aeronaves;
+
+    // Habilitado antes de qualquer thread: o flag é lido sem sincronização (somente na execução simples)
+    if (config->perfil) {
+        perfil_habilitar(true);
+    }
+
+    // Os processos de trabalho são criados antes de qualquer thread e aguardam a largada
+    if (config->processos > 0) {
+        sim->processos = processos_criar(config->processos, sim->aeronaves, num_aero);
+        if (sim->processos == NULL) {
+            fprintf(stderr, "Erro ao criar os processos de trabalho\n");
+            return 1;
+        }
+    }
+
+    //imprimir_estado_banqueiro(ctrl);
+    // A thread de controle do banqueiro, tem que ser criada antes das aeronaves (percebemos isso da pior maneira)
+    pthread_t ctrl_thread;
+    int res = pthread_create(&ctrl_thread, NULL, banqueiro_thread, (void *)ctrl);
+    if (res != 0) {
+        fprintf(stderr, "Erro ao criar thread de controle: %d\n", res);
+        return 1;
+    }
+
+    if (config->continuo) {
+        return executar_continuo_simulacao(sim, ctrl_thread);
+    }
+
+    // O makespan de uma execução restaurada inclui o tempo simulado antes do checkpoint
+    long long inicio_ns = tempo_monotonico_ns() - sim->decorrido_ns;
+    if (ctrl->escala != NULL) {
+        escala_iniciar(ctrl->escala);
+    }
+
+    int erro = 0;
+    if (sim->processos != NULL) {
+        size_t falhas = processos_executar(sim->processos);
+        if (falhas > 0) {
+            controle_encerrar(ctrl);
+            pthread_join(ctrl_thread, NULL);
+            fprintf(stderr, "Erro: %zu processo(s) de trabalho falharam; resultados descartados\n", falhas);
+            return 1;
+        }
+    } else {
+        size_t criadas = 0;
+        for (; criadas < num_aero; criadas++) {
+            res = pthread_create(&sim->threads[criadas], NULL, aeronave_thread, (void *)&sim->aeronaves[criadas]);
+            if (res != 0) {
+                fprintf(stderr, "Erro ao criar thread: %d\n", res);
+                erro = 1;
+                break;
+            }
+        }
+
+        // As aeronaves já criadas terminam sem as demais (que não alocaram nada) e são unidas
+        for (size_t i = 0; i < criadas; i++) {
+            pthread_join(sim->threads[i], (void**)&sim->resultados[i]);
+            if (sim->resultados[i] == NULL) erro = 1;
+        }
+    }
+    long long makespan_ns = tempo_monotonico_ns() - inicio_ns;
+
+    controle_encerrar(ctrl);
+    pthread_join(ctrl_thread, NULL);
+    if (config->soak) {
+        invariantes_encerrar(&sim->invariantes);
+    }
+    if (erro != 0) return 1;
+
+    double* maiores_esperas = (double*)malloc(num_aero * sizeof(double));
+    if (maiores_esperas == NULL) return 1;
+
+    if (sim->imprimir) {
+        printf("\n=== RESULTADOS DA SIMULAÇÃO ===\n");
+    }
+    double soma_total = 0;
+    for (size_t i = 0; i < num_aero; i++) {
+        resultado_aeronave_t* r = sim->processos != NULL ? &sim->processos->resultados[i] : sim->resultados[i];
+        soma_total += r->media_espera;
+        maiores_esperas[i] = r->maior_espera;
+        // No soak a frota é grande demais para uma linha por aeronave
+        if (!sim->imprimir || config->soak) continue;
+        printf("Aeronave %s - Média de espera: %.2f ms (maior: %.2f ms)", r->id, r->media_espera, r->maior_espera);
+        if (r->timeouts > 0) {
+            printf(" - prazos expirados: %u", r->timeouts);
+        }
+        printf("\n");
+    }
+
+    // Cauda da distribuição: p99 das maiores esperas individuais de cada aeronave
+    qsort(maiores_esperas, num_aero, sizeof(double), comparar_double);
+    sim->resultado.makespan_ns = makespan_ns;
+    sim->resultado.espera_media_ms = soma_total / (double)num_aero;
+    sim->resultado.p99_maior_espera_ms = maiores_esperas[(size_t)(0.99 * (double)(num_aero - 1))];
+    sim->resultado.concessoes = ctrl->estatisticas.concessoes;
+    sim->resultado.verificacoes_seguranca = ctrl->estatisticas.verificacoes_seguranca;
+    if (config->soak) {
+        sim->resultado.violacoes = atomic_load(&sim->invariantes.violacoes);
+    }
+    free(maiores_esperas);
+    if (!sim->imprimir) return sim->resultado.violacoes == 0 ? 0 : 1;
+
+    printf("Média geral de espera: %.2f ms\n", sim->resultado.espera_media_ms);
+    printf("P99 da maior espera por aeronave: %.2f ms\n", sim->resultado.p99_maior_espera_ms);
+    controle_relatorio_seguranca(ctrl);
+    controle_relatorio_selecao(ctrl);
+    controle_relatorio_esperas(ctrl);
+    if (config->prazo_setor_ms > 0) {
+        controle_relatorio_cancelamentos(ctrl);
+    }
+    printf("Makespan: %.2f s\n", (double)makespan_ns / 1e9);
+    if (config->arquivo_checkpoint != NULL) {
+        controle_relatorio_checkpoints(ctrl);
+    }
+    if (sim->processos != NULL) {
+        printf("Processos de trabalho: %zu | memória compartilhada: %.2f MiB\n", sim->processos->num_processos,
+               (double)memoria_usada() / (1024.0 * 1024.0));
+    }
+    if (ctrl->escala != NULL) {
+        escala_relatorio(ctrl->escala);
+    }
+    if (config->perfil) {
+        perfil_relatorio();
+    }
+    if (config->soak) {
+        invariantes_relatorio(&sim->invariantes);
+    }
+
+    return sim->resultado.violacoes == 0 ? 0 : 1;
+}
+
+void simulacao_destroy(simulacao_t* sim) {
+    controle_t* ctrl = sim->controle;
+    size_t num_aero = sim->config.num_aeronaves;
+
+    // Os resultados das threads foram alocados por elas; os dos processos estão no segmento
+    if (sim->resultados != NULL) {
+        for (size_t i = 0; i < num_aero; i++) {
+            free(sim->resultados[i]);
+        }
+    }
+    free(sim->resultados);
+    free(sim->threads);
+
+    if (ctrl != NULL) {
+        if (ctrl->invariantes != NULL) {
+            invariantes_destroy(ctrl->invariantes);
+        }
+        if (ctrl->escala != NULL) {
+            escala_destroy(ctrl->escala);
+        }
+        if (ctrl->planejador != NULL) {
+            planejador_destroy(ctrl->planejador);
+            topologia_destroy(&sim->topologia);
+        }
+    }
+    destroy_setores(sim->setores, sim->config.num_setores);
+    destroy_aeronaves(sim->aeronaves, sim->estados, num_aero);
+    if (ctrl != NULL) {
+        destroy_controle(ctrl);
+        memoria_liberar(ctrl);
+    }
+    processos_destroy(sim->processos);
+    if (sim->config.processos > 0) {
+        memoria_encerrar();
+    }
+
+    memset(sim, 0, sizeof(*sim));
+}
@@ -0,0 +1,110 @@
+#ifndef SIMULACAO_H
+#define SIMULACAO_H
+
+#include "config.h"
+#include "controle.h"
+#include "setor.h"
+#include "aeronave.h"
+#include "topologia.h"
+#include "escala.h"
+#include "invariantes.h"
+#include "processos.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * @brief Resumo de uma execução em lote (o que a varredura agrega)
+ *
+ * @param makespan_ns fim da última aeronave desde a largada
+ * @param espera_media_ms média das esperas médias das aeronaves
+ * @param p99_maior_espera_ms p99 da maior espera individual de cada aeronave
+ * @param concessoes concessões feitas pelo banqueiro
+ * @param verificacoes_seguranca verificações de segurança do banqueiro
+ * @param violacoes violações de invariantes (soak)
+ */
+typedef struct simulacao_resultado {
+    long long makespan_ns;
+    double espera_media_ms;
+    double p99_maior_espera_ms;
+    size_t concessoes;
+    size_t verificacoes_seguranca;
+    size_t violacoes;
+} simulacao_resultado_t;
+
+/**
+ * @brief Uma simulação completa e reentrante: controle, setores, frota, gerador e estatísticas
+ *
+ * Todo o estado da execução pertence à instância (o gerador está no controle e em cada aeronave),
+ * de forma que várias instâncias podem executar ao mesmo tempo no mesmo processo. Os recursos
+ * únicos do processo ficam restritos à execução simples: o perfil, o segmento compartilhado de
+ * --processos e o log de eventos (a varredura roda em silêncio).
+ *
+ * @param config cópia dos parâmetros desta execução
+ * @param imprimir imprime a preparação e os relatórios (execução simples); a varredura só lê o resultado
+ * @param controle
+ * @param setores
+ * @param aeronaves
+ * @param estados
+ * @param topologia válida somente com config.topologia
+ * @param planejador válido somente com config.topologia
+ * @param escala válida somente com config.escala
+ * @param invariantes válido somente com config.soak
+ * @param processos processos de trabalho (NULL sem --processos)
+ * @param threads threads das aeronaves (modo em lote com threads)
+ * @param resultados resultado de cada aeronave (modo em lote)
+ * @param decorrido_ns tempo simulado antes do checkpoint restaurado
+ * @param resultado resumo preenchido por simulacao_executar
+ */
+typedef struct simulacao {
+    config_t config;
+    bool imprimir;
+
+    controle_t* controle;
+    setor_t* setores;
+    aeronave_t* aeronaves;
+    aeronave_estado_t* estados;
+
+    topologia_t topologia;
+    planejador_t planejador;
+    escala_t escala;
+    invariantes_t invariantes;
+    processos_t* processos;
+
+    pthread_t* threads;
+    resultado_aeronave_t** resultados;
+
+    long long decorrido_ns;
+    simulacao_resultado_t resultado;
+} simulacao_t;
+
+/**
+ * @brief Monta a simulação: controle, setores, frota e rotas, topologia, escala e verificador
+ *
+ * Na restauração as dimensões e as rotas vêm do instantâneo. A instância não pode ser movida
+ * depois de criada (o controle guarda ponteiros para o planejador, a escala e o verificador).
+ *
+ * @param sim instância a preencher
+ * @param config parâmetros (copiados)
+ * @param imprimir imprime a preparação e os relatórios
+ * @return true em sucesso (a mensagem de erro já foi impressa caso contrário)
+ */
+bool simulacao_criar(simulacao_t* sim, const config_t* config, bool imprimir);
+
+/**
+ * @brief Executa a simulação até a última aeronave (lote) ou a última aposentadoria (contínuo)
+ *
+ * @param sim instância criada por simulacao_criar
+ * @return int 0 em sucesso; 1 em erro ou com violações de invariantes
+ */
+int simulacao_executar(simulacao_t* sim);
+
+/**
+ * @brief Libera todos os recursos da instância
+ *
+ * @param sim
+ */
+void simulacao_destroy(simulacao_t* sim);
+
+#endif
@@ -0,0 +1,353 @@
+#include "topologia.h"
+#include "perfil.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Monta o CSR a partir de uma lista de arestas não direcionadas (a[k], b[k])
+static bool montar_csr(topologia_t* topo, size_t num_setores, const int* a, const int* b, size_t num_arestas) {
+    topo->num_setores = num_setores;
+    topo->inicio = (size_t*)calloc(num_setores + 1, sizeof(size_t));
+    topo->vizinhos = (int*)malloc((2 * num_arestas + 1) * sizeof(int));
+    if (topo->inicio == NULL || topo->vizinhos == NULL) {
+        topologia_destroy(topo);
+        return false;
+    }
+
+    // Conta o grau de cada setor e transforma em deslocamentos (soma de prefixos)
+    for (size_t k = 0; k < num_arestas; k++) {
+        topo->inicio[a[k] + 1]++;
+        topo->inicio[b[k] + 1]++;
+    }
+    for (size_t v = 0; v < num_setores; v++) {
+        topo->inicio[v + 1] += topo->inicio[v];
+    }
+
+    size_t* pos = (size_t*)malloc(num_setores * sizeof(size_t));
+    if (pos == NULL) {
+        topologia_destroy(topo);
+        return false;
+    }
+    memcpy(pos, topo->inicio, num_setores * sizeof(size_t));
+
+    for (size_t k = 0; k < num_arestas; k++) {
+        topo->vizinhos[pos[a[k]]++] = b[k];
+        topo->vizinhos[pos[b[k]]++] = a[k];
+    }
+
+    free(pos);
+    return true;
+}
+
+bool topologia_gerar_grade(topologia_t* topo, size_t num_setores) {
+    size_t colunas = (size_t)ceil(sqrt((double)num_setores));
+    if (colunas == 0) colunas = 1;
+
+    // No máximo 2 arestas por setor (direita e abaixo)
+    int* a = (int*)malloc((2 * num_setores + 1) * sizeof(int));
+    int* b = (int*)malloc((2 * num_setores + 1) * sizeof(int));
+    if (a == NULL || b == NULL) {
+        free(a);
+        free(b);
+        return false;
+    }
+
+    size_t num_arestas = 0;
+    for (size_t v = 0; v < num_setores; v++) {
+        if ((v + 1) % colunas != 0 && v + 1 < num_setores) {
+            a[num_arestas] = (int)v;
+            b[num_arestas++] = (int)(v + 1);
+        }
+        if (v + colunas < num_setores) {
+            a[num_arestas] = (int)v;
+            b[num_arestas++] = (int)(v + colunas);
+        }
+    }
+
+    bool ok = montar_csr(topo, num_setores, a, b, num_arestas);
+    free(a);
+    free(b);
+    return ok;
+}
+
+bool topologia_carregar(topologia_t* topo, const char* arquivo, size_t num_setores) {
+    FILE* f = fopen(arquivo, "r");
+    if (f == NULL) {
+        perror("Falha ao abrir o arquivo de topologia");
+        return false;
+    }
+
+    size_t cap = 64, num_arestas = 0;
+    int* a = (int*)malloc(cap * sizeof(int));
+    int* b = (int*)malloc(cap * sizeof(int));
+    bool ok = a != NULL && b != NULL;
+
+    char linha[256];
+    size_t num_linha = 0;
+    while (ok && fgets(linha, sizeof(linha), f) != NULL) {
+        num_linha++;
+        int u, v;
+        if (linha[0] == '#' || sscanf(linha, "%d %d", &u, &v) != 2) continue;
+
+        if (u < 0 || v < 0 || (size_t)u >= num_setores || (size_t)v >= num_setores || u == v) {
+            fprintf(stderr, "ERRO: aresta inválida na linha %zu de %s (%d %d).\n", num_linha, arquivo, u, v);
+            ok = false;
+            break;
+        }
+
+        if (num_arestas == cap) {
+            cap *= 2;
+            int* na = (int*)realloc(a, cap * sizeof(int));
+            if (na != NULL) a = na;
+            int* nb = (int*)realloc(b, cap * sizeof(int));
+            if (nb != NULL) b = nb;
+            if (na == NULL || nb == NULL) {
+                ok = false;
+                break;
+            }
+        }
+        a[num_arestas] = u;
+        b[num_arestas++] = v;
+    }
+    fclose(f);
+
+    if (ok) ok = montar_csr(topo, num_setores, a, b, num_arestas);
+    free(a);
+    free(b);
+    return ok;
+}
+
+void topologia_destroy(topologia_t* topo) {
+    if (topo == NULL) return;
+
+    free(topo->inicio);
+    free(topo->vizinhos);
+    topo->inicio = NULL;
+    topo->vizinhos = NULL;
+}
+
+bool planejador_init(planejador_t* plan, const topologia_t* topo, double peso_contencao) {
+    size_t n = topo->num_setores;
+
+    plan->topo = topo;
+    plan->peso_contencao = peso_contencao;
+    plan->demanda_soma = 0;
+    plan->epoca = 0;
+
+    // Com remoção preguiçosa cada aresta pode inserir uma entrada no heap
+    plan->heap_cap = topo->inicio[n] + 1;
+
+    plan->demanda = (unsigned long*)calloc(n, sizeof(unsigned long));
+    plan->demanda_total = (unsigned long*)calloc(n, sizeof(unsigned long));
+    plan->dist = (double*)malloc(n * sizeof(double));
+    plan->anterior = (int*)malloc(n * sizeof(int));
+    plan->visita = (unsigned int*)calloc(n, sizeof(unsigned int));
+    plan->heap_custo = (double*)malloc(plan->heap_cap * sizeof(double));
+    plan->heap_setor = (int*)malloc(plan->heap_cap * sizeof(int));
+    plan->caminho = (int*)malloc(n * sizeof(int));
+
+    if (!plan->demanda || !plan->demanda_total || !plan->dist || !plan->anterior || 
+        !plan->visita || !plan->heap_custo || !plan->heap_setor || !plan->caminho) {
+        planejador_destroy(plan);
+        return false;
+    }
+
+    pthread_mutex_init(&plan->lock, NULL);
+    return true;
+}
+
+void planejador_destroy(planejador_t* plan) {
+    if (plan == NULL) return;
+
+    free(plan->demanda);
+    free(plan->demanda_total);
+    free(plan->dist);
+    free(plan->anterior);
+    free(plan->visita);
+    free(plan->heap_custo);
+    free(plan->heap_setor);
+    free(plan->caminho);
+    plan->demanda = plan->demanda_total = NULL;
+    plan->dist = plan->heap_custo = NULL;
+    plan->anterior = plan->heap_setor = plan->caminho = NULL;
+    plan->visita = NULL;
+
+    pthread_mutex_destroy(&plan->lock);
+}
+
+static void heap_inserir(planejador_t* plan, size_t* len, double custo, int setor) {
+    size_t i = (*len)++;
+    while (i > 0) {
+        size_t pai = (i - 1) / 2;
+        if (plan->heap_custo[pai] <= custo) break;
+        plan->heap_custo[i] = plan->heap_custo[pai];
+        plan->heap_setor[i] = plan->heap_setor[pai];
+        i = pai;
+    }
+    plan->heap_custo[i] = custo;
+    plan->heap_setor[i] = setor;
+}
+
+static void heap_remover_min(planejador_t* plan, size_t* len, double* custo, int* setor) {
+    *custo = plan->heap_custo[0];
+    *setor = plan->heap_setor[0];
+
+    double ultimo_custo = plan->heap_custo[--(*len)];
+    int ultimo_setor = plan->heap_setor[*len];
+
+    size_t i = 0;
+    while (2 * i + 1 < *len) {
+        size_t filho = 2 * i + 1;
+        if (filho + 1 < *len && plan->heap_custo[filho + 1] < plan->heap_custo[filho]) filho++;
+        if (ultimo_custo <= plan->heap_custo[filho]) break;
+        plan->heap_custo[i] = plan->heap_custo[filho];
+        plan->heap_setor[i] = plan->heap_setor[filho];
+        i = filho;
+    }
+    plan->heap_custo[i] = ultimo_custo;
+    plan->heap_setor[i] = ultimo_setor;
+}
+
+// Custo de entrar no setor v dada a demanda já planejada (executado sob plan->lock)
+static double custo_setor(const planejador_t* plan, int v, double demanda_media) {
+    return 1.0 + plan->peso_contencao * (double)plan->demanda[v] / (1.0 + demanda_media);
+}
+
+// Caminho de custo mínimo sem passar por `evitar` (-1 se nenhum). Retorna 0 se o destino
+// for inalcançável (executado sob plan->lock)
+static size_t menor_caminho(planejador_t* plan, int origem, int destino, int evitar, int* caminho) {
+    const topologia_t* topo = plan->topo;
+
+    double demanda_media = (double)plan->demanda_soma / (double)topo->num_setores;
+
+    // Nova época: setores com visita != epoca são tratados como não alcançados (dist = infinito)
+    if (++plan->epoca == 0) {
+        memset(plan->visita, 0, topo->num_setores * sizeof(unsigned int));
+        plan->epoca = 1;
+    }
+    unsigned int epoca = plan->epoca;
+
+    size_t heap_len = 0;
+    plan->visita[origem] = epoca;
+    plan->dist[origem] = custo_setor(plan, origem, demanda_media);
+    plan->anterior[origem] = -1;
+    heap_inserir(plan, &heap_len, plan->dist[origem], origem);
+
+    bool alcancado = false;
+    while (heap_len > 0) {
+        double d;
+        int u;
+        heap_remover_min(plan, &heap_len, &d, &u);
+        if (d > plan->dist[u]) continue; // entrada obsoleta
+
+        // Parada antecipada: o destino saiu do heap com a menor distância
+        if (u == destino) {
+            alcancado = true;
+            break;
+        }
+
+        for (size_t k = topo->inicio[u]; k < topo->inicio[u + 1]; k++) {
+            int v = topo->vizinhos[k];
+            if (v == evitar) continue;
+
+            double nd = d + custo_setor(plan, v, demanda_media);
+            if (plan->visita[v] != epoca || nd < plan->dist[v]) {
+                plan->visita[v] = epoca;
+                plan->dist[v] = nd;
+                plan->anterior[v] = u;
+                if (heap_len < plan->heap_cap) heap_inserir(plan, &heap_len, nd, v);
+            }
+        }
+    }
+
+    if (!alcancado) return 0;
+
+    // Reconstrói o caminho de trás para frente e inverte
+    size_t len = 0;
+    for (int v = destino; v != -1; v = plan->anterior[v]) {
+        caminho[len++] = v;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        int tmp = caminho[i];
+        caminho[i] = caminho[len - 1 - i];
+        caminho[len - 1 - i] = tmp;
+    }
+    return len;
+}
+
+// Soma a demanda dos setores do caminho (executado sob plan->lock)
+static void somar_demanda(planejador_t* plan, const int* caminho, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        plan->demanda[caminho[i]]++;
+        plan->demanda_total[caminho[i]]++;
+    }
+    plan->demanda_soma += len;
+}
+
+size_t planejador_rota(planejador_t* plan, int origem, int destino, int* caminho) {
+    long long adquirido_ns = perfil_lock(&plan->lock, PERFIL_LOCK_PLANEJADOR);
+
+    size_t len = menor_caminho(plan, origem, destino, -1, caminho);
+    if (len == 0) {
+        caminho[len++] = origem;
+    }
+    somar_demanda(plan, caminho, len);
+
+    perfil_unlock(&plan->lock, PERFIL_LOCK_PLANEJADOR, adquirido_ns);
+
+    return len;
+}
+
+size_t planejador_desvio(planejador_t* plan, int origem, int destino, int evitar, int* caminho) {
+    long long adquirido_ns = perfil_lock(&plan->lock, PERFIL_LOCK_PLANEJADOR);
+
+    size_t len = menor_caminho(plan, origem, destino, evitar, caminho);
+    if (len > 1) {
+        somar_demanda(plan, caminho + 1, len - 1);
+    }
+
+    perfil_unlock(&plan->lock, PERFIL_LOCK_PLANEJADOR, adquirido_ns);
+
+    return len;
+}
+
+void planejador_remover_rota(planejador_t* plan, const int* caminho, size_t len) {
+    long long adquirido_ns = perfil_lock(&plan->lock, PERFIL_LOCK_PLANEJADOR);
+    for (size_t i = 0; i < len; i++) {
+        if (plan->demanda[caminho[i]] > 0) {
+            plan->demanda[caminho[i]]--;
+            plan->demanda_soma--;
+        }
+    }
+    perfil_unlock(&plan->lock, PERFIL_LOCK_PLANEJADOR, adquirido_ns);
+}
+
+void planejador_relatorio(planejador_t* plan) {
+    size_t n = plan->topo->num_setores;
+
+    long long adquirido_ns = perfil_lock(&plan->lock, PERFIL_LOCK_PLANEJADOR);
+
+    double soma = 0, soma_quad = 0;
+    unsigned long maximo = 0;
+    size_t sem_demanda = 0;
+    for (size_t v = 0; v < n; v++) {
+        double d = (double)plan->demanda_total[v];
+        soma += d;
+        soma_quad += d * d;
+        if (plan->demanda_total[v] > maximo) maximo = plan->demanda_total[v];
+        if (plan->demanda_total[v] == 0) sem_demanda++;
+    }
+
+    perfil_unlock(&plan->lock, PERFIL_LOCK_PLANEJADOR, adquirido_ns);
+
+    double media = soma / (double)n;
+    double variancia = soma_quad / (double)n - media * media;
+    double desvio = variancia > 0 ? sqrt(variancia) : 0.0;
+
+    printf("\n=== DEMANDA PLANEJADA POR SETOR (peso de contenção %.2f) ===\n", plan->peso_contencao);
+    printf("Passagens: %.0f | Média: %.2f | Máxima: %lu | Desvio padrão: %.2f\n", soma, media, maximo, desvio);
+    printf("Coeficiente de variação: %.3f | Máxima/média: %.2f | Setores sem demanda: %zu de %zu\n",
+           media > 0 ? desvio / media : 0.0, media > 0 ? (double)maximo / media : 0.0, sem_demanda, n);
+}
@@ -0,0 +1,159 @@
+#ifndef TOPOLOGIA_H
+#define TOPOLOGIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * @brief Grafo de adjacência entre setores (não direcionado, formato CSR)
+ * 
+ * Os vizinhos do setor v são vizinhos[inicio[v]] .. vizinhos[inicio[v + 1] - 1].
+ * 
+ * @param num_setores número de vértices
+ * @param inicio deslocamento da lista de vizinhos de cada setor (num_setores + 1 posições)
+ * @param vizinhos listas de adjacência concatenadas
+ */
+typedef struct topologia {
+    size_t num_setores;
+    size_t* inicio;
+    int* vizinhos;
+} topologia_t;
+
+/**
+ * @brief Gera uma grade aproximadamente quadrada (vizinhança de 4) com num_setores setores
+ * 
+ * @param topo saída
+ * @param num_setores 
+ * @return true em sucesso
+ */
+bool topologia_gerar_grade(topologia_t* topo, size_t num_setores);
+
+/**
+ * @brief Carrega o grafo de um arquivo com uma aresta "a b" por linha (índices a partir de 0)
+ * 
+ * Linhas vazias ou iniciadas por '#' são ignoradas.
+ * 
+ * @param topo saída
+ * @param arquivo caminho do arquivo
+ * @param num_setores número de setores da simulação (índices devem ser menores)
+ * @return true em sucesso
+ */
+bool topologia_carregar(topologia_t* topo, const char* arquivo, size_t num_setores);
+
+/**
+ * @brief Libera a memória do grafo
+ * 
+ * @param topo 
+ */
+void topologia_destroy(topologia_t* topo);
+
+/**
+ * @brief Planejador de rotas sobre a topologia com custo sensível à contenção
+ * 
+ * O custo de entrar no setor v é 1 + peso_contencao * demanda[v] / (1 + demanda média),
+ * onde demanda[v] é o número de rotas já planejadas (e ainda ativas) que passam por v,
+ * uma estimativa da fila esperada no setor. Cada rota é um caminho de custo mínimo
+ * (Dijkstra com parada antecipada), portanto sem setores repetidos.
+ * 
+ * Pode ser usado por várias threads (o gerador de chegadas planeja e o banqueiro remove
+ * as rotas aposentadas na operação contínua).
+ * 
+ * @param topo grafo de setores
+ * @param peso_contencao peso da contenção no custo (0 = menor caminho)
+ * @param demanda rotas ativas que passam por cada setor
+ * @param demanda_total rotas planejadas que passaram por cada setor desde o início
+ * @param demanda_soma soma de demanda[] (para a média)
+ * @param lock protege as demandas e a área de trabalho
+ * @param dist área de trabalho do Dijkstra
+ * @param anterior área de trabalho do Dijkstra
+ * @param visita marca de época de cada setor (evita reinicializar os vetores a cada rota)
+ * @param epoca época atual
+ * @param heap_custo heap binário (custos) com remoção preguiçosa
+ * @param heap_setor heap binário (setores)
+ * @param heap_cap capacidade do heap
+ * @param caminho rascunho de criar_rota_planejada (num_setores; só a thread que monta a frota ou
+ *                gera as chegadas planeja rotas novas)
+ */
+typedef struct planejador {
+    const topologia_t* topo;
+    double peso_contencao;
+
+    unsigned long* demanda;
+    unsigned long* demanda_total;
+    unsigned long demanda_soma;
+
+    pthread_mutex_t lock;
+
+    double* dist;
+    int* anterior;
+    unsigned int* visita;
+    unsigned int epoca;
+    double* heap_custo;
+    int* heap_setor;
+    size_t heap_cap;
+
+    int* caminho;
+} planejador_t;
+
+/**
+ * @brief Inicializa o planejador
+ * 
+ * @param plan 
+ * @param topo grafo de setores (deve viver mais que o planejador)
+ * @param peso_contencao peso da contenção no custo
+ * @return true em sucesso
+ */
+bool planejador_init(planejador_t* plan, const topologia_t* topo, double peso_contencao);
+
+/**
+ * @brief Libera a memória do planejador
+ * 
+ * @param plan 
+ */
+void planejador_destroy(planejador_t* plan);
+
+/**
+ * @brief Planeja uma rota de origem até destino e soma sua demanda aos setores
+ * 
+ * @param plan 
+ * @param origem setor de origem
+ * @param destino setor de destino
+ * @param caminho saída com os setores da rota (capacidade mínima: num_setores)
+ * @return size_t tamanho da rota (1 se o destino for inalcançável: só a origem)
+ */
+size_t planejador_rota(planejador_t* plan, int origem, int destino, int* caminho);
+
+/**
+ * @brief Planeja um desvio de origem até destino sem passar pelo setor `evitar`
+ * 
+ * A demanda é somada a todos os setores do caminho exceto a origem (já contada
+ * na rota em andamento).
+ * 
+ * @param plan 
+ * @param origem setor atual
+ * @param destino setor final
+ * @param evitar setor excluído do caminho
+ * @param caminho saída com os setores do desvio, começando pela origem (capacidade mínima: num_setores)
+ * @return size_t tamanho do desvio ou 0 se o destino for inalcançável sem o setor evitado
+ */
+size_t planejador_desvio(planejador_t* plan, int origem, int destino, int evitar, int* caminho);
+
+/**
+ * @brief Remove a demanda de uma rota que deixou o sistema
+ * 
+ * @param plan 
+ * @param caminho setores da rota
+ * @param len tamanho da rota
+ */
+void planejador_remover_rota(planejador_t* plan, const int* caminho, size_t len);
+
+/**
+ * @brief Imprime o equilíbrio da demanda planejada por setor
+ * (máxima, média, desvio padrão, coeficiente de variação, setores sem demanda)
+ * 
+ * @param plan 
+ */
+void planejador_relatorio(planejador_t* plan);
+
+#endif
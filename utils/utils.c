@@ -12,7 +12,15 @@
 // Tamanho máximo do buffer para a mensagem formatada.
 #define BUFFER_SIZE 512
 
+static bool log_habilitado = true;
+
+void definir_log_habilitado(bool habilitado) {
+    log_habilitado = habilitado;
+}
+
 void printf_timestamped(const char* format, ...) {
+    if (!log_habilitado) return;
+
     time_t rawtime;
     struct tm *info;
     char timestamp_buffer[TIMESTAMP_SIZE];
@@ -46,6 +54,37 @@ struct timespec get_abs_timeout(int seconds) {
     return ts;
 }
 
+long long tempo_monotonico_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void aleatorio_semear(aleatorio_t* g, uint64_t semente) {
+    g->estado = semente;
+}
+
+uint64_t aleatorio_proximo(aleatorio_t* g) {
+    uint64_t z = (g->estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+size_t aleatorio_intervalo(aleatorio_t* g, size_t n) {
+    // Multiplicação de 32 x 32 bits no lugar do módulo: sem divisão e sem o viés dos bits baixos
+    if (n <= UINT32_MAX) {
+        return (size_t)(((aleatorio_proximo(g) >> 32) * (uint64_t)n) >> 32);
+    }
+    return (size_t)(aleatorio_proximo(g) % n);
+}
+
+double aleatorio_uniforme(aleatorio_t* g) {
+    // 53 bits de mantissa, deslocados meio passo: nunca 0 nem 1
+    return ((double)(aleatorio_proximo(g) >> 11) + 0.5) / 9007199254740992.0;
+}
+
 char* create_id(char prefix, int index) {
     if (index < 0) return NULL;
 
@@ -76,4 +115,83 @@ char* create_id(char prefix, int index) {
     snprintf(res, total_len, "%c-%d", (int)prefix, index);
 
     return res;
-}
\ No newline at end of file
+}
+
+void* alocar_alinhado(size_t n, size_t tamanho) {
+    size_t total = n * tamanho;
+    if (total == 0) return NULL;
+
+    // aligned_alloc exige que o tamanho seja múltiplo do alinhamento
+    total = (total + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+
+    return aligned_alloc(CACHE_LINE_SIZE, total);
+}
+
+
+// Índice da faixa: valores < HISTOGRAMA_SUB são exatos, os demais usam o expoente
+// (posição do bit mais significativo) e os 3 bits seguintes como sub-faixa
+static size_t histograma_faixa(unsigned long long v) {
+    if (v < HISTOGRAMA_SUB) return (size_t)v;
+
+    int e = 63 - __builtin_clzll(v);
+    size_t sub = (size_t)(v >> (e - 3)) & (HISTOGRAMA_SUB - 1);
+    return (size_t)(e - 2) * HISTOGRAMA_SUB + sub;
+}
+
+// Maior valor que cai na faixa de índice i
+static long long histograma_limite_superior(size_t i) {
+    if (i < HISTOGRAMA_SUB) return (long long)i;
+
+    int e = (int)(i / HISTOGRAMA_SUB) + 2;
+    unsigned long long sub = i % HISTOGRAMA_SUB;
+    unsigned long long limite = ((HISTOGRAMA_SUB + sub + 1) << (e - 3)) - 1;
+    return limite > (unsigned long long)INT64_MAX ? INT64_MAX : (long long)limite;
+}
+
+void histograma_init(histograma_t* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void histograma_registrar(histograma_t* h, long long valor) {
+    if (valor < 0) valor = 0;
+
+    h->faixas[histograma_faixa((unsigned long long)valor)]++;
+    h->total++;
+    h->soma += valor;
+    if (valor > h->max) h->max = valor;
+}
+
+void histograma_registrar_atomico(histograma_t* h, long long valor) {
+    if (valor < 0) valor = 0;
+
+    __atomic_fetch_add(&h->faixas[histograma_faixa((unsigned long long)valor)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->total, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->soma, valor, __ATOMIC_RELAXED);
+
+    long long atual = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (valor > atual && !__atomic_compare_exchange_n(&h->max, &atual, valor, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // `atual` foi atualizado pela falha do CAS
+    }
+}
+
+long long histograma_percentil(const histograma_t* h, double p) {
+    if (h->total == 0) return 0;
+
+    // Posição (1..total) da amostra do percentil
+    uint64_t alvo = (uint64_t)(p / 100.0 * (double)h->total);
+    if (alvo == 0) alvo = 1;
+
+    uint64_t acumulado = 0;
+    for (size_t i = 0; i < HISTOGRAMA_FAIXAS; i++) {
+        acumulado += h->faixas[i];
+        if (acumulado >= alvo) {
+            long long limite = histograma_limite_superior(i);
+            return limite < h->max ? limite : h->max;
+        }
+    }
+    return h->max;
+}
+
+double histograma_media(const histograma_t* h) {
+    return h->total == 0 ? 0.0 : (double)h->soma / (double)h->total;
+}
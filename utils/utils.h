@@ -1,6 +1,16 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Tamanho de uma linha de cache (x86-64 e a maioria dos ARM64)
+#define CACHE_LINE_SIZE 64
+
+// Alinha (e preenche) uma struct para que cada instância ocupe linhas de cache próprias
+#define ALINHADO_CACHE __attribute__((aligned(CACHE_LINE_SIZE)))
+
 /**
  * @brief Cria um id com um prefixo determinado no formato {prefix}-{index}
  * 
@@ -13,10 +23,65 @@ char* create_id(char prefix, int index);
 /**
  * @brief Imprime uma mensagem no formato timestampado [HH:MM:SS.mmm] mensagem
  * 
+ * Não imprime nada se o log foi desabilitado com definir_log_habilitado(false).
+ * 
  * @param format 
  */
 void printf_timestamped(const char* format, ...);
 
+/**
+ * @brief Habilita ou desabilita as mensagens de printf_timestamped (execuções longas)
+ * 
+ * @param habilitado 
+ */
+void definir_log_habilitado(bool habilitado);
+
+/**
+ * @brief Gerador pseudoaleatório reentrante (splitmix64)
+ * 
+ * Substitui rand(), cujo estado é global ao processo: cada simulação tem o seu gerador e cada
+ * aeronave o seu, de forma que instâncias em paralelo não disputam nem misturam sequências.
+ * Não é thread-safe: cada gerador pertence a uma única thread por vez.
+ * 
+ * @param estado
+ */
+typedef struct aleatorio {
+    uint64_t estado;
+} aleatorio_t;
+
+/**
+ * @brief Reinicia o gerador (a mesma semente reproduz a mesma sequência)
+ * 
+ * @param g 
+ * @param semente 
+ */
+void aleatorio_semear(aleatorio_t* g, uint64_t semente);
+
+/**
+ * @brief Próximo valor de 64 bits
+ * 
+ * @param g 
+ * @return uint64_t 
+ */
+uint64_t aleatorio_proximo(aleatorio_t* g);
+
+/**
+ * @brief Inteiro uniforme em [0, n) (n > 0)
+ * 
+ * @param g 
+ * @param n 
+ * @return size_t 
+ */
+size_t aleatorio_intervalo(aleatorio_t* g, size_t n);
+
+/**
+ * @brief Real uniforme no intervalo aberto (0, 1)
+ * 
+ * @param g 
+ * @return double 
+ */
+double aleatorio_uniforme(aleatorio_t* g);
+
 /**
  * @brief Obtém um tempo absoluto para timeout baseado no tempo atual + segundos fornecidos
  * 
@@ -25,4 +90,80 @@ void printf_timestamped(const char* format, ...);
  */
 struct timespec get_abs_timeout(int seconds);
 
+/**
+ * @brief Instante atual de CLOCK_MONOTONIC em nanossegundos
+ * 
+ * @return long long 
+ */
+long long tempo_monotonico_ns(void);
+
+/**
+ * @brief Aloca um vetor de `n` elementos alinhado à linha de cache.
+ * Deve ser liberado com free().
+ * 
+ * @param n número de elementos
+ * @param tamanho tamanho de cada elemento (sizeof)
+ * @return void* ponteiro alinhado ou NULL em caso de falha
+ */
+void* alocar_alinhado(size_t n, size_t tamanho);
+
+// Sub-faixas lineares por potência de 2 no histograma (erro relativo máximo de 12,5%)
+#define HISTOGRAMA_SUB 8
+#define HISTOGRAMA_FAIXAS (64 * HISTOGRAMA_SUB)
+
+/**
+ * @brief Histograma logarítmico de memória fixa para valores não negativos (ex.: tempos em ns)
+ * 
+ * @param faixas contagem por faixa
+ * @param total número de amostras
+ * @param soma soma das amostras
+ * @param max maior amostra
+ */
+typedef struct histograma {
+    uint64_t faixas[HISTOGRAMA_FAIXAS];
+    uint64_t total;
+    long long soma;
+    long long max;
+} histograma_t;
+
+/**
+ * @brief Zera o histograma
+ * 
+ * @param h 
+ */
+void histograma_init(histograma_t* h);
+
+/**
+ * @brief Registra uma amostra (valores negativos são tratados como 0)
+ * 
+ * @param h 
+ * @param valor 
+ */
+void histograma_registrar(histograma_t* h, long long valor);
+
+/**
+ * @brief Registra uma amostra com operações atômicas (histograma compartilhado entre threads)
+ * 
+ * @param h 
+ * @param valor 
+ */
+void histograma_registrar_atomico(histograma_t* h, long long valor);
+
+/**
+ * @brief Estima o percentil p (0 a 100) pelo limite superior da faixa correspondente
+ * 
+ * @param h 
+ * @param p 
+ * @return long long 
+ */
+long long histograma_percentil(const histograma_t* h, double p);
+
+/**
+ * @brief Média das amostras (0 se vazio)
+ * 
+ * @param h 
+ * @return double 
+ */
+double histograma_media(const histograma_t* h);
+
 #endif
@@ -0,0 +1,173 @@
+#include "varredura.h"
+#include "simulacao.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/**
+ * @brief Um ponto da grade e os agregados das suas repetições (protegidos por saida_lock)
+ */
+typedef struct ponto {
+    size_t num_aeronaves;
+    size_t num_setores;
+    size_t comprimento_rota;
+    politica_tipo_t politica;
+    selecao_tipo_t selecao;
+
+    size_t concluidas;
+    size_t falhas;
+    double makespan_soma_s;
+    double makespan_min_s;
+    double makespan_max_s;
+    double espera_soma_ms;
+    double p99_soma_ms;
+    size_t concessoes;
+    size_t verificacoes;
+} ponto_t;
+
+typedef struct varredura {
+    const config_t* config;
+    ponto_t* pontos;
+    size_t num_pontos;
+
+    // Execução k: ponto k / repeticoes, semente config->semente + k. As repetições de um ponto são
+    // consecutivas, então os pontos terminam (e são impressos) ao longo da varredura
+    size_t total;
+    atomic_size_t proxima;
+
+    pthread_mutex_t saida_lock;
+    size_t falhas;
+} varredura_t;
+
+// Uma linha CSV com os agregados do ponto (chamado sob saida_lock)
+static void imprimir_ponto(const ponto_t* p) {
+    size_t validas = p->concluidas - p->falhas;
+    double d = validas > 0 ? (double)validas : 1.0;
+
+    printf("%zu,%zu,%zu,%s,%s,%zu,%zu,%.3f,%.3f,%.3f,%.2f,%.2f,%.1f,%.1f\n", p->num_aeronaves, p->num_setores, p->comprimento_rota,
+           politica_nome(p->politica), selecao_nome(p->selecao), p->concluidas, p->falhas, p->makespan_soma_s / d,
+           validas > 0 ? p->makespan_min_s : 0.0, p->makespan_max_s, p->espera_soma_ms / d, p->p99_soma_ms / d,
+           (double)p->concessoes / d, (double)p->verificacoes / d);
+    fflush(stdout);
+}
+
+static void* trabalhador(void* arg) {
+    varredura_t* v = (varredura_t*)arg;
+    size_t repeticoes = v->config->repeticoes;
+
+    // A instância é grande (escala, verificador): fica no heap e é reaproveitada entre execuções
+    simulacao_t* sim = (simulacao_t*)malloc(sizeof(simulacao_t));
+    if (sim == NULL) return NULL;
+
+    while (true) {
+        size_t k = atomic_fetch_add(&v->proxima, 1);
+        if (k >= v->total) break;
+        ponto_t* p = &v->pontos[k / repeticoes];
+
+        config_t config = *v->config;
+        config.varredura = false;
+        config.num_aeronaves = p->num_aeronaves;
+        config.num_setores = p->num_setores;
+        config.comprimento_rota = p->comprimento_rota;
+        config.politica = p->politica;
+        config.selecao = p->selecao;
+        config.semente = v->config->semente + k;
+
+        bool ok = simulacao_criar(sim, &config, false) && simulacao_executar(sim) == 0;
+        simulacao_resultado_t r = sim->resultado;
+        simulacao_destroy(sim);
+
+        pthread_mutex_lock(&v->saida_lock);
+        p->concluidas++;
+        if (ok) {
+            double makespan_s = (double)r.makespan_ns / 1e9;
+            if (p->concluidas - p->falhas == 1 || makespan_s < p->makespan_min_s) p->makespan_min_s = makespan_s;
+            if (makespan_s > p->makespan_max_s) p->makespan_max_s = makespan_s;
+            p->makespan_soma_s += makespan_s;
+            p->espera_soma_ms += r.espera_media_ms;
+            p->p99_soma_ms += r.p99_maior_espera_ms;
+            p->concessoes += r.concessoes;
+            p->verificacoes += r.verificacoes_seguranca;
+        } else {
+            p->falhas++;
+            v->falhas++;
+            fprintf(stderr, "ERRO: execução %zu (%zu aeronaves, %zu setores, rota %zu, %s, %s, semente %llu) falhou\n", k,
+                    p->num_aeronaves, p->num_setores, p->comprimento_rota, politica_nome(p->politica), selecao_nome(p->selecao),
+                    (unsigned long long)config.semente);
+        }
+        if (p->concluidas == repeticoes) {
+            imprimir_ponto(p);
+        }
+        pthread_mutex_unlock(&v->saida_lock);
+    }
+
+    free(sim);
+    return NULL;
+}
+
+bool varredura_executar(const config_t* config) {
+    varredura_t v;
+    v.config = config;
+    v.num_pontos = config->num_grade_aeronaves * config->num_grade_setores * config->num_grade_rota * config->num_grade_politicas *
+                   config->num_grade_selecoes;
+    v.total = v.num_pontos * config->repeticoes;
+    v.falhas = 0;
+    atomic_init(&v.proxima, 0);
+    pthread_mutex_init(&v.saida_lock, NULL);
+
+    v.pontos = (ponto_t*)calloc(v.num_pontos, sizeof(ponto_t));
+    if (v.pontos == NULL) return false;
+
+    size_t i = 0;
+    for (size_t a = 0; a < config->num_grade_aeronaves; a++) {
+        for (size_t s = 0; s < config->num_grade_setores; s++) {
+            for (size_t r = 0; r < config->num_grade_rota; r++) {
+                for (size_t q = 0; q < config->num_grade_politicas; q++) {
+                    for (size_t e = 0; e < config->num_grade_selecoes; e++) {
+                        ponto_t* p = &v.pontos[i++];
+                        p->num_aeronaves = config->grade_aeronaves[a];
+                        p->num_setores = config->grade_setores[s];
+                        p->comprimento_rota = config->grade_rota[r];
+                        p->politica = config->grade_politicas[q];
+                        p->selecao = config->grade_selecoes[e];
+                    }
+                }
+            }
+        }
+    }
+
+    size_t num_trabalhos = config->trabalhos < v.total ? config->trabalhos : v.total;
+    fprintf(stderr, "Varredura: %zu pontos x %zu repetições | %zu simulações simultâneas | semente %llu\n", v.num_pontos,
+            config->repeticoes, num_trabalhos, (unsigned long long)config->semente);
+    printf("aeronaves,setores,rota,politica,selecao,execucoes,falhas,makespan_medio_s,makespan_min_s,makespan_max_s,"
+           "espera_media_ms,p99_maior_espera_ms,concessoes,verificacoes_seguranca\n");
+    fflush(stdout);
+
+    long long inicio_ns = tempo_monotonico_ns();
+    pthread_t* threads = (pthread_t*)malloc(num_trabalhos * sizeof(pthread_t));
+    size_t criadas = 0;
+    while (threads != NULL && criadas < num_trabalhos) {
+        int res = pthread_create(&threads[criadas], NULL, trabalhador, &v);
+        if (res != 0) {
+            fprintf(stderr, "Erro ao criar trabalhador da varredura: %d\n", res);
+            break;
+        }
+        criadas++;
+    }
+    for (size_t t = 0; t < criadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double duracao_s = (double)(tempo_monotonico_ns() - inicio_ns) / 1e9;
+
+    size_t executadas = atomic_load(&v.proxima) < v.total ? atomic_load(&v.proxima) : v.total;
+    fprintf(stderr, "Varredura: %zu execuções em %.2f s (%.2f execuções/s) | falhas: %zu\n", executadas, duracao_s,
+            duracao_s > 0 ? (double)executadas / duracao_s : 0.0, v.falhas);
+
+    free(threads);
+    free(v.pontos);
+    pthread_mutex_destroy(&v.saida_lock);
+    return criadas > 0 && executadas == v.total && v.falhas == 0;
+}
@@ -0,0 +1,23 @@
+#ifndef VARREDURA_H
+#define VARREDURA_H
+
+#include "config.h"
+
+#include <stdbool.h>
+
+/**
+ * @brief Executa a grade de configurações da varredura em simulações paralelas no mesmo processo
+ *
+ * Cada ponto da grade (aeronaves x setores x comprimento de rota x política x seleção) é executado
+ * config->repeticoes vezes, com as sementes config->semente, config->semente + 1, ... na ordem
+ * das execuções. Até config->trabalhos simulações rodam ao mesmo tempo, cada uma em sua
+ * própria instância (simulacao_t). Assim que todas as repetições de um ponto terminam, uma
+ * linha CSV com os agregados é impressa em stdout (a ordem das linhas segue o término); o
+ * resumo da varredura vai para stderr.
+ *
+ * @param config parâmetros lidos por config_parse com config->varredura
+ * @return true se todas as execuções terminaram sem erro
+ */
+bool varredura_executar(const config_t* config);
+
+#endif